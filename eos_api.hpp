@@ -32,8 +32,10 @@
 #include <eosio/crypto.hpp>
 #include <eosio/eosio.hpp>
 #include <eosio/print.hpp>
+#include <eosio/system.hpp>
 #include <stdio.h>
 #include <vector>
+#include "randomds_verify.hpp"
 
 
 /**************************************************
@@ -54,10 +56,19 @@
    #define PROVABLE_PAYER _self
 #endif // PROVABLE_PAYER
 
+#ifndef PROVABLE_TELEMETRY_SIZE
+    #define PROVABLE_TELEMETRY_SIZE 32
+#endif // PROVABLE_TELEMETRY_SIZE
+static_assert(PROVABLE_TELEMETRY_SIZE > 0, "PROVABLE_TELEMETRY_SIZE must be at least 1");
+
 #define provable_query(...) __provable_query(PROVABLE_PAYER, __VA_ARGS__, _self)
 #define provable_newRandomDSQuery(...) __provable_newRandomDSQuery(PROVABLE_PAYER, __VA_ARGS__, _self)
 #define provable_queryId_localEmplace(...) __provable_queryId_localEmplace(__VA_ARGS__, _self)
 #define provable_queryId_match(...) __provable_queryId_match(__VA_ARGS__, _self)
+#define provable_setQueryTemplate(...) __provable_setQueryTemplate(PROVABLE_PAYER, __VA_ARGS__, _self)
+#define provable_queryTemplate(...) __provable_queryTemplate(PROVABLE_PAYER, __VA_ARGS__, _self)
+#define provable_expandQueryTemplate(...) __provable_expandQueryTemplate(__VA_ARGS__, _self)
+#define provable_telemetry_dump() __provable_telemetry_dump(_self)
 
 
 /**************************************************
@@ -70,20 +81,11 @@ using namespace std;
 
 /**************************************************
  *                    CONSTANTS                   *
- *                   Proof Types                  *
+ *                    Network                     *
  **************************************************/
-const uint8_t proofType_NONE = 0x00;
-const uint8_t proofType_TLSNotary = 0x10;
-const uint8_t proofType_Ledger = 0x30;
-const uint8_t proofType_Android = 0x40;
-const uint8_t proofType_Native = 0xF0;
-const uint8_t proofStorage_IPFS = 0x01;
-
-const uint8_t CODE_HASH_RANDOMDS[32] = {
-    253, 148, 250, 113, 188, 11, 161, 13, 57, 212, 100, 208, 216, 244, 101, 239, 238, 240, 162, 118, 78, 56, 135, 252, 201, 223, 65, 222, 210, 15, 80, 92
-};
-const uint8_t LEDGERKEY[64] = {
-    127, 185, 86, 70, 156, 92, 155, 137, 132, 13, 85, 180, 53, 55, 230, 106, 152, 221, 72, 17, 234, 10, 39, 34, 66, 114, 194, 229, 98, 41, 17, 232, 83, 122, 47, 142, 134, 164, 107, 174, 200, 40, 100, 233, 141, 208, 30, 156, 204, 47, 139, 197, 223, 201, 203, 229, 169, 26, 41, 4, 152, 221, 150, 228
+struct provable_network_default
+{
+    static constexpr char context_name[] = PROVABLE_NETWORK_NAME;
 };
 
 
@@ -115,6 +117,16 @@ struct [[eosio::table, eosio::contract("provableconn")]] spubkey
     eosio::checksum256 get_randomDS_lastSessionPubkeyHash() const { return randomDS_lastSessionPubkeyHash; }
 };
 
+struct [[eosio::table, eosio::contract("provableconn")]] qtemplate
+{
+    name id;
+    std::string datasource;
+    std::vector<uint8_t> query;
+    uint8_t prooftype;
+
+    uint64_t primary_key() const { return id.value; }
+};
+
 
 /**************************************************
  *                PROVABLE  TABLE                 *
@@ -139,11 +151,43 @@ struct [[eosio::table, eosio::contract(CONTRACT_NAME)]] queryid
     uint64_t primary_key() const { return key.value; }
 };
 
+#ifdef PROVABLE_TELEMETRY
+struct telemetry_entry
+{
+    name shortqueryid;
+    uint32_t issued; // seconds since epoch
+    uint32_t callback; // seconds since epoch, 0 while the callback is pending
+    uint16_t query_size; // query body size, or total params size for template queries
+    uint8_t templated; // 1 for template queries
+    uint16_t result_size;
+    uint16_t proof_size;
+    uint8_t proof_code; // provable_randomDS_proofVerify return code, 0xFF if not verified
+};
+
+// The row type is not named telemetry, so that contracts can have a telemetry action (the ABI keys the structs by name)
+struct [[eosio::table("telemetry"), eosio::contract(CONTRACT_NAME)]] ptelemetry
+{
+    name key;
+    uint32_t head; // next slot of the ring buffer to be written
+    uint64_t queries;
+    uint64_t callbacks;
+    std::vector<telemetry_entry> entries; // ring buffer of the last PROVABLE_TELEMETRY_SIZE queries
+    std::vector<uint32_t> latency; // latency[i]: callbacks with a latency of [2^(i-1), 2^i) seconds, the last one is open ended
+    std::vector<uint32_t> proof_codes; // proof_codes[i]: proofs verified with return code i
+
+    uint64_t primary_key() const { return key.value; }
+};
+#endif // PROVABLE_TELEMETRY
+
 typedef eosio::multi_index<name("snonce"), snonce> ds_snonce;
 typedef eosio::multi_index<name("cbaddr"), cbaddr> ds_cbaddr;
 typedef eosio::multi_index<name("spubkey"), spubkey> ds_spubkey;
+typedef eosio::multi_index<name("qtemplate"), qtemplate> ds_qtemplate;
 typedef eosio::multi_index<name("scommitment"), scommitment> ds_scommitment;
 typedef eosio::multi_index<name("queryid"), queryid> ds_queryid;
+#ifdef PROVABLE_TELEMETRY
+typedef eosio::multi_index<name("telemetry"), ptelemetry> ds_telemetry;
+#endif // PROVABLE_TELEMETRY
 
 
 /**************************************************
@@ -320,6 +364,129 @@ std::vector<uint8_t> checksum256_to_vector32(const eosio::checksum256 cs)
 }
 
 
+/**************************************************
+ *               PROVABLE TELEMETRY               *
+ *                 Implementation                 *
+ **************************************************/
+// Enabled defining PROVABLE_TELEMETRY: a single row per contract keeps the last PROVABLE_TELEMETRY_SIZE
+// queries in a ring buffer plus bucketed counters, so RAM and CPU per query stay bounded
+const uint8_t __provable_telemetry_latency_buckets = 16;
+const uint8_t __provable_telemetry_proof_codes = 8;
+const uint8_t __provable_telemetry_no_proof = 0xFF;
+
+#ifdef PROVABLE_TELEMETRY
+
+void __provable_telemetry_issue(const eosio::checksum256 queryId, const size_t query_size, const bool templated, const name sender)
+{
+    name myQueryId_short;
+    std::memcpy(&myQueryId_short, &queryId.get_array()[0], sizeof(myQueryId_short));
+    telemetry_entry entry;
+    entry.shortqueryid = myQueryId_short;
+    entry.issued = eosio::current_time_point().sec_since_epoch();
+    entry.callback = 0;
+    entry.query_size = query_size > 0xFFFF ? 0xFFFF : query_size;
+    entry.templated = templated;
+    entry.result_size = 0;
+    entry.proof_size = 0;
+    entry.proof_code = __provable_telemetry_no_proof;
+    ds_telemetry telemetries(sender, sender.value);
+    auto itr = telemetries.find(sender.value);
+    if (itr == telemetries.end())
+    {
+        telemetries.emplace(sender, [&](auto &o) {
+            o.key = sender;
+            o.head = 1 % PROVABLE_TELEMETRY_SIZE;
+            o.queries = 1;
+            o.callbacks = 0;
+            o.entries.resize(PROVABLE_TELEMETRY_SIZE);
+            o.entries[0] = entry;
+            o.latency.resize(__provable_telemetry_latency_buckets);
+            o.proof_codes.resize(__provable_telemetry_proof_codes);
+        });
+        return;
+    }
+    telemetries.modify(itr, sender, [&](auto &o) {
+        o.entries[o.head] = entry;
+        o.head = (o.head + 1) % PROVABLE_TELEMETRY_SIZE;
+        o.queries++;
+    });
+}
+
+void __provable_telemetry_callback(const eosio::checksum256 queryId, const uint8_t proof_code, const size_t result_size, const size_t proof_size, const name sender)
+{
+    ds_telemetry telemetries(sender, sender.value);
+    auto itr = telemetries.find(sender.value);
+    if (itr == telemetries.end())
+        return;
+    name myQueryId_short;
+    std::memcpy(&myQueryId_short, &queryId.get_array()[0], sizeof(myQueryId_short));
+    const uint32_t now = eosio::current_time_point().sec_since_epoch();
+    telemetries.modify(itr, sender, [&](auto &o) {
+        if (proof_code != __provable_telemetry_no_proof && proof_code < __provable_telemetry_proof_codes)
+            o.proof_codes[proof_code]++;
+        for (auto &e : o.entries)
+        {
+            if (e.shortqueryid != myQueryId_short || e.issued == 0)
+                continue;
+            // The callback is recorded only once, even if both queryId_match and proofVerify are called
+            if (e.callback == 0)
+            {
+                e.callback = now;
+                uint32_t latency = now > e.issued ? now - e.issued : 0;
+                uint8_t bucket = 0;
+                for (; latency > 0 && bucket < __provable_telemetry_latency_buckets - 1; latency >>= 1)
+                    bucket++;
+                o.latency[bucket]++;
+                o.callbacks++;
+            }
+            if (proof_code != __provable_telemetry_no_proof)
+            {
+                e.proof_code = proof_code;
+                e.result_size = result_size > 0xFFFF ? 0xFFFF : result_size;
+                e.proof_size = proof_size > 0xFFFF ? 0xFFFF : proof_size;
+            }
+            break;
+        }
+    });
+}
+
+// Print the telemetry row, to be called from a contract action that only reads it
+void __provable_telemetry_dump(const name sender)
+{
+    ds_telemetry telemetries(sender, sender.value);
+    auto itr = telemetries.find(sender.value);
+    if (itr == telemetries.end())
+    {
+        print("{}");
+        return;
+    }
+    print("{\"queries\":", itr->queries, ",\"callbacks\":", itr->callbacks, ",\"latency\":[");
+    for (size_t i = 0; i < itr->latency.size(); i++)
+        print(i == 0 ? "" : ",", itr->latency[i]);
+    print("],\"proof_codes\":[");
+    for (size_t i = 0; i < itr->proof_codes.size(); i++)
+        print(i == 0 ? "" : ",", itr->proof_codes[i]);
+    print("],\"entries\":[");
+    // From the oldest to the newest entry
+    bool first = true;
+    for (size_t i = 0; i < itr->entries.size(); i++)
+    {
+        const telemetry_entry &e = itr->entries[(itr->head + i) % itr->entries.size()];
+        if (e.issued == 0)
+            continue;
+        print(first ? "" : ",", "{\"shortqueryid\":\"", e.shortqueryid, "\",\"issued\":", e.issued, ",\"callback\":", e.callback,
+            ",\"query_size\":", e.query_size, ",\"templated\":", (uint32_t)e.templated, ",\"result_size\":", e.result_size, ",\"proof_size\":", e.proof_size, ",\"proof_code\":", (uint32_t)e.proof_code, "}");
+        first = false;
+    }
+    print("]}");
+}
+#else
+void __provable_telemetry_issue(const eosio::checksum256 queryId, const size_t query_size, const bool templated, const name sender) {}
+void __provable_telemetry_callback(const eosio::checksum256 queryId, const uint8_t proof_code, const size_t result_size, const size_t proof_size, const name sender) {}
+void __provable_telemetry_dump(const name sender) {}
+#endif // PROVABLE_TELEMETRY
+
+
 /**************************************************
  *               INTERNAL FUNCTIONS               *
  *                  Definitions                   *
@@ -386,8 +553,8 @@ bool __provable_queryId_match(const eosio::checksum256 queryId, const name sende
     // Compare the queryids and check if string values are empty
     if (queryId_str != queryId_str__expected || queryId_str.empty() || queryId_str__expected.empty())
         return false;
-    else
-        return true;
+    __provable_telemetry_callback(queryId, __provable_telemetry_no_proof, 0, 0, sender);
+    return true;
 }
 
 void __provable_queryId_localEmplace(const eosio::checksum256 myQueryId, const name sender)
@@ -417,6 +584,7 @@ eosio::checksum256 __provable_query(const name user, const unsigned int timestam
         "querystr"_n,
         std::make_tuple(sender, (int8_t)1, (uint32_t)timestamp, queryId, datasource, query, prooftype)
     ).send();
+    __provable_telemetry_issue(queryId, query.size(), false, sender);
     return queryId;
 }
 
@@ -440,31 +608,30 @@ eosio::checksum256 __provable_query(const name user, const std::string datasourc
  *                 Provable Query                 *
  *                   Bytearrays                   *
  **************************************************/
-eosio::checksum256 __provable_query(const name user, const unsigned int timestamp, const std::string datasource, const vector<uint8_t> query, const uint8_t prooftype, const name sender)
+eosio::checksum256 __provable_query(const name user, const unsigned int timestamp, const std::string datasource, const vector<uint8_t> &query, const uint8_t prooftype, const name sender)
 {
     const eosio::checksum256 queryId = __provable_getNextQueryId(sender);
     printhex(query.data(), query.size());
-    auto n = name{user};
-    const std::string str = n.to_string();
     action(permission_level{user, "active"_n},
         "provableconn"_n,
         "queryba"_n,
         std::make_tuple(sender, (int8_t)1, (uint32_t)timestamp, queryId, datasource, query, prooftype)
     ).send();
+    __provable_telemetry_issue(queryId, query.size(), false, sender);
     return queryId;
 }
 
-eosio::checksum256 __provable_query(const name user, const std::string datasource, const vector<uint8_t> query, const name sender)
+eosio::checksum256 __provable_query(const name user, const std::string datasource, const vector<uint8_t> &query, const name sender)
 {
     return __provable_query(user, 0, datasource, query, 0, sender);
 }
 
-eosio::checksum256 __provable_query(const name user, const unsigned int timestamp, const std::string datasource, const vector<uint8_t> query, const name sender)
+eosio::checksum256 __provable_query(const name user, const unsigned int timestamp, const std::string datasource, const vector<uint8_t> &query, const name sender)
 {
     return __provable_query(user, timestamp, datasource, query, 0, sender);
 }
 
-eosio::checksum256 __provable_query(const name user, const std::string datasource, const vector<uint8_t> query, const uint8_t prooftype, const name sender)
+eosio::checksum256 __provable_query(const name user, const std::string datasource, const vector<uint8_t> &query, const uint8_t prooftype, const name sender)
 {
     return __provable_query(user, 0, datasource, query, prooftype, sender);
 }
@@ -472,108 +639,116 @@ eosio::checksum256 __provable_query(const name user, const std::string datasourc
 
 /**************************************************
  *                 Provable Query                 *
- *                   Random DS                    *
+ *                   Templates                    *
  **************************************************/
-void __provable_randomDS_setCommitment(const eosio::checksum256 queryId, const eosio::checksum256 commitment, const name payer)
+// A template (datasource, query body and proof type) is stored once in the connector table, then each
+// query only carries the template id and its parameters. In the query body every "${n}" (n = 0..9) is
+// replaced by params[n]; for the "computation" datasource the body is the bytearray returned by
+// provable_set_computation_args() and the params are appended to it as further arguments.
+void __provable_setQueryTemplate(const name user, const name id, const std::string datasource, const vector<uint8_t> &query, const uint8_t prooftype, const name sender)
 {
-    name myQueryId_short; // Calculate the short queryId, to use it as a key of the table
-    std::memcpy(&myQueryId_short, &queryId.get_array()[0], sizeof(myQueryId_short));
-    ds_scommitment last_commitments(payer, payer.value); // Set the commitment in the eos table of the caller
-    last_commitments.emplace(payer, [&](auto &o) { // The key must be a uint64_t so a short query Id is used
-        o.shortqueryid = myQueryId_short;
-        o.queryid = queryId;
-        o.commitment = commitment;
-    });
+    action(permission_level{user, "active"_n},
+        "provableconn"_n,
+        "settemplate"_n,
+        std::make_tuple(sender, id, datasource, query, prooftype)
+    ).send();
 }
 
-eosio::checksum256 __provable_newRandomDSQuery(const name user, const uint32_t _delay, const uint8_t _nbytes, const name sender)
+void __provable_setQueryTemplate(const name user, const name id, const std::string datasource, const vector<uint8_t> &query, const name sender)
 {
-    // 1. NBYTES - Convert nbytes to bytearray
-    std::vector<uint8_t> nbytesBa(1);
-    nbytesBa[0] = _nbytes;
-
-    // 2. SESSIONKEYHASH - Get the sessionKeyHash from the ledger public key.
-    const eosio::checksum256 sessionPubkeyHash = __provable_randomDS_getSessionPubkeyHash();
-    std::vector<uint8_t> sessionPubkeyHashBa(32);
-    std::vector<uint8_t> sessionPubkeyHashBa2(32);
-    sessionPubkeyHashBa = checksum256_to_vector32(sessionPubkeyHash);
-
-    // 3. UNONCE - Need something block dependent so we decided to perform the hash of those 4 block dependent fields. This value have to be unpredictable from Provable
-    const size_t tx_size = transaction_size();
-    const int tapos_block_num_ = tapos_block_num();
-    const int tapos_block_prefix_ = tapos_block_prefix();
-    uint8_t unonce[sizeof(tx_size) + sizeof(tapos_block_num_) + sizeof(tapos_block_prefix_)]; // Fill the unonce array: now() + transaction_size + tapos_block_num + tapos_block_prefix
-    std::memcpy(unonce, &tx_size, sizeof(tx_size));
-    std::memcpy(unonce + sizeof(tx_size), &tapos_block_num_, sizeof(tapos_block_num_));
-    std::memcpy(unonce + sizeof(tx_size) + sizeof(tapos_block_num_), &tapos_block_prefix_, sizeof(tapos_block_prefix_));
-    eosio::checksum256 unonceHash = sha256((char *)unonce, sizeof(unonce)); // Container for the unonce hash
-    std::vector<uint8_t> unonceHashBa(32); // Convert the unonce hash in bytearray
-    unonceHashBa = checksum256_to_vector32(unonceHash);
-
-    // 4. DELAY - Delay converted in a big endian bytearray
-    const uint32_t delayLedgerTime = _delay * 10; // Convert from seconds to ledger timer ticks
-    std::vector<uint8_t> delayBaBigEndian(32);
-    delayBaBigEndian = uint32_to_vector32_bigendian(delayLedgerTime);
-
-    // Set args2 to be passed as params of the provable "random" query
-    std::vector<std::vector<uint8_t>> args;
-    args.push_back(unonceHashBa);
-    args.push_back(nbytesBa);
-    args.push_back(sessionPubkeyHashBa);
-    args.push_back(delayBaBigEndian);
-    std::vector<uint8_t> args2;
-    for(auto && a : args)
-        args2.insert(args2.end(), a.begin(), a.end());
+    __provable_setQueryTemplate(user, id, datasource, query, 0, sender);
+}
 
-    // Call the provable_query and get the queryId
-    const eosio::checksum256 queryId = __provable_query(user,"random", args2, proofType_Ledger, sender); // proofType and datasource are always fixed in this function
+void __provable_setQueryTemplate(const name user, const name id, const std::string datasource, const std::string query, const uint8_t prooftype, const name sender)
+{
+    __provable_setQueryTemplate(user, id, datasource, string_to_vector(query), prooftype, sender);
+}
 
-    // Calculate the commitment and call a function to set it
-    std::vector<uint8_t> delayBa(8); // delay converted to 8 byte
-    delayBa = uint32_to_vector8(delayLedgerTime);
-    uint8_t* charArray = &unonceHashBa[0];
-    eosio::checksum256 unonceHashBaHash = invert_checksum256(sha256((char *) charArray, unonceHashBa.size())); // unonce has to be passed hashed
-    uint8_t commitmentTbh[8 + 1 + 32 + args[2].size()]; // Calculate the commitment to be hashed with the size of: 8 + 1 + 32 + 32
-    std::memcpy(commitmentTbh, &delayBa[0], 8); // 8
-    std::memcpy(commitmentTbh + 8, &args[1][0], 1); // 8 + 1
-    std::memcpy(commitmentTbh + 8 + 1, &unonceHashBaHash.get_array()[0], 16); // 8 + 1 + 16
-    std::memcpy(commitmentTbh + 8 + 1 + 16, &unonceHashBaHash.get_array()[1], 16); // 8 + 1 + 32 == commitmentSlice1
-    std::memcpy(commitmentTbh + delayBa.size() + args[1].size() + 32, &args[2][0], args[2].size()); // 8 + 1 + 32 + 32 (commitmentSlice1 + sessionPubkeyHashBa)
-    eosio::checksum256 commitment = sha256((char *)commitmentTbh, sizeof(commitmentTbh)); // Container for the commitment hash
-    const name payer = user; // Payer for setting the commitment
-    __provable_randomDS_setCommitment(queryId, commitment, payer); // Call the function to set query Id and commitment in the table
+void __provable_setQueryTemplate(const name user, const name id, const std::string datasource, const std::string query, const name sender)
+{
+    __provable_setQueryTemplate(user, id, datasource, string_to_vector(query), 0, sender);
+}
 
+eosio::checksum256 __provable_queryTemplate(const name user, const unsigned int timestamp, const name id, const std::vector<std::string> params, const name sender)
+{
+    const eosio::checksum256 queryId = __provable_getNextQueryId(sender);
+    action(permission_level{user, "active"_n},
+        "provableconn"_n,
+        "querytpl"_n,
+        std::make_tuple(sender, (int8_t)1, (uint32_t)timestamp, queryId, id, params)
+    ).send();
+    size_t params_size = 0;
+    for (auto && p : params)
+        params_size += p.size();
+    __provable_telemetry_issue(queryId, params_size, true, sender);
     return queryId;
 }
 
-void __provable_randomDS_get_signature_component(uint8_t component[32], const uint8_t signature[], const uint8_t signature_len, const uint8_t length_idx)
+eosio::checksum256 __provable_queryTemplate(const name user, const name id, const std::vector<std::string> params, const name sender)
 {
-    eosio::internal_use_do_not_use::eosio_assert(signature_len > length_idx, "Invalid index");
-    uint8_t component_len = signature[length_idx];
-    uint8_t byte_to_jump = component_len % 32;
-    std::memcpy(component, &signature[length_idx + 1 + byte_to_jump], component_len - byte_to_jump);
+    return __provable_queryTemplate(user, 0, id, params, sender);
 }
 
-bool __provable_randomDS_matchBytes32Prefix(const eosio::checksum256 content, const uint8_t prefix[], const uint8_t prefix_len, const uint8_t n_random_bytes)
+// Template expansion shared by the contracts and the connector (see tools/provableconn)
+std::vector<uint8_t> __provable_expandQueryTemplateBody(const std::string &datasource, const std::vector<uint8_t> &body, const std::vector<std::string> &params)
 {
-    eosio::internal_use_do_not_use::eosio_assert(prefix_len == n_random_bytes, "Prefix length and random bytes number should match.");
-    const eosio::checksum256 content_inverted = invert_checksum256(content);
-    uint8_t *first_word = (uint8_t *)&content_inverted.get_array()[0];
-    uint8_t *second_word = (uint8_t *)&content_inverted.get_array()[1];
-    for (int i = 0; i < n_random_bytes; ++i)
+    std::vector<uint8_t> query;
+    if (datasource == "computation")
+    {
+        // [args_number][first_arg_len][first_arg]...[last_arg_len][last_arg], params become the last args
+        eosio::internal_use_do_not_use::eosio_assert(!body.empty() && body[0] + params.size() <= 255, "Max arguments allowed are 255");
+        query = body;
+        query[0] += params.size();
+        for (auto && p : params)
+        {
+            eosio::internal_use_do_not_use::eosio_assert(p.size() <= 255, "Max argument length allowed is 255");
+            query.push_back(p.size()); // argument length
+            query.insert(query.end(), p.begin(), p.end()); // argument
+        }
+        return query;
+    }
+    query.reserve(body.size());
+    for (size_t i = 0; i < body.size(); i++)
     {
-        if (i < 16)
+        if (i + 3 < body.size() && body[i] == '$' && body[i + 1] == '{' && body[i + 2] >= '0' && body[i + 2] <= '9' && body[i + 3] == '}')
         {
-            if (first_word[i] != prefix[i])
-                return false;
+            const size_t param_idx = body[i + 2] - '0';
+            eosio::internal_use_do_not_use::eosio_assert(param_idx < params.size(), "Missing query template parameter");
+            query.insert(query.end(), params[param_idx].begin(), params[param_idx].end());
+            i += 3;
         }
         else
         {
-            if (second_word[i] != prefix[i])
-                return false;
+            query.push_back(body[i]);
         }
     }
-    return true;
+    return query;
+}
+
+// Expand a registered template with the connector code, returning the full query body it will execute
+std::vector<uint8_t> __provable_expandQueryTemplate(const name id, const std::vector<std::string> params, const name sender)
+{
+    ds_qtemplate templates("provableconn"_n, sender.value);
+    auto itr = templates.find(id.value);
+    eosio::internal_use_do_not_use::eosio_assert(itr != templates.end(), "Query template not found");
+    return __provable_expandQueryTemplateBody(itr->datasource, itr->query, params);
+}
+
+
+/**************************************************
+ *                 Provable Query                 *
+ *                   Random DS                    *
+ **************************************************/
+void __provable_randomDS_setCommitment(const eosio::checksum256 queryId, const eosio::checksum256 commitment, const name payer)
+{
+    name myQueryId_short; // Calculate the short queryId, to use it as a key of the table
+    std::memcpy(&myQueryId_short, &queryId.get_array()[0], sizeof(myQueryId_short));
+    ds_scommitment last_commitments(payer, payer.value); // Set the commitment in the eos table of the caller
+    last_commitments.emplace(payer, [&](auto &o) { // The key must be a uint64_t so a short query Id is used
+        o.shortqueryid = myQueryId_short;
+        o.queryid = queryId;
+        o.commitment = commitment;
+    });
 }
 
 bool __provable_randomDS_test_pubkey_signature(const uint8_t whatever, const uint8_t v, const uint8_t r[32], const uint8_t s[32], const eosio::checksum256 digest, const uint8_t pubkey[64])
@@ -598,166 +773,95 @@ bool __provable_randomDS_test_pubkey_signature(const uint8_t whatever, const uin
     return true;
 }
 
-bool __provable_randomDS_verifySig(const eosio::checksum256 digest, const uint8_t der_signature[], const uint8_t der_signature_len, const uint8_t pubkey[64])
+// Crypto used by the shared Random DS code (randomds_verify.hpp) inside the contracts
+struct __provable_randomDS_eosio_crypto
 {
-    uint8_t r[32];
-    uint8_t s[32];
-    __provable_randomDS_get_signature_component(r, der_signature, der_signature_len, 3);
-    __provable_randomDS_get_signature_component(s, der_signature, der_signature_len, 4 + der_signature[3] + 1);
-    // We try either with v=27 or with v=28
-    bool test_v27 = __provable_randomDS_test_pubkey_signature(0, 27, r, s, digest, pubkey);
-    bool test_v28 = __provable_randomDS_test_pubkey_signature(0, 28, r, s, digest, pubkey);
-    return test_v27 || test_v28;
+    static void sha256(const uint8_t *data, const size_t data_len, uint8_t digest[32])
+    {
+        const std::array<uint8_t, 32> hash = eosio::sha256((const char *)data, data_len).extract_as_byte_array();
+        std::memcpy(digest, hash.data(), 32);
+    }
+
+    static bool verify(const uint8_t digest[32], const uint8_t r[32], const uint8_t s[32], const uint8_t pubkey[64])
+    {
+        std::array<uint8_t, 32> digest_ba;
+        std::memcpy(digest_ba.data(), digest, 32);
+        const eosio::checksum256 digest_cs = eosio::checksum256(digest_ba);
+        // We try either with v=27 or with v=28
+        return __provable_randomDS_test_pubkey_signature(0, 27, r, s, digest_cs, pubkey) ||
+            __provable_randomDS_test_pubkey_signature(0, 28, r, s, digest_cs, pubkey);
+    }
+};
+
+eosio::checksum256 __provable_newRandomDSQuery(const name user, const uint32_t _delay, const uint8_t _nbytes, const name sender)
+{
+    // The query args are assembled in place: unonceHash (32) + nbytes (1) + sessionPubkeyHash (32) + delay (32)
+    uint8_t args[RANDOMDS_QUERY_ARGS_LEN];
+
+    // 1. UNONCE - Need something block dependent so we decided to perform the hash of those 4 block dependent fields. This value have to be unpredictable from Provable
+    const size_t tx_size = transaction_size();
+    const int tapos_block_num_ = tapos_block_num();
+    const int tapos_block_prefix_ = tapos_block_prefix();
+    uint8_t unonce[sizeof(tx_size) + sizeof(tapos_block_num_) + sizeof(tapos_block_prefix_)]; // Fill the unonce array: now() + transaction_size + tapos_block_num + tapos_block_prefix
+    std::memcpy(unonce, &tx_size, sizeof(tx_size));
+    std::memcpy(unonce + sizeof(tx_size), &tapos_block_num_, sizeof(tapos_block_num_));
+    std::memcpy(unonce + sizeof(tx_size) + sizeof(tapos_block_num_), &tapos_block_prefix_, sizeof(tapos_block_prefix_));
+    const eosio::checksum256 unonceHash = sha256((char *)unonce, sizeof(unonce));
+    std::memcpy(args, unonceHash.get_array().data(), 32);
+
+    // 2. NBYTES
+    args[32] = _nbytes;
+
+    // 3. SESSIONKEYHASH - Get the sessionKeyHash from the ledger public key.
+    const eosio::checksum256 sessionPubkeyHash = __provable_randomDS_getSessionPubkeyHash();
+    std::memcpy(args + 32 + 1, sessionPubkeyHash.get_array().data(), 32);
+
+    // 4. DELAY - Delay converted in a big endian bytearray
+    const uint32_t delayLedgerTime = _delay * 10; // Convert from seconds to ledger timer ticks
+    std::memset(args + 32 + 1 + 32, 0, 32 - 4);
+    for (int i = 0; i < 4; i++)
+        args[RANDOMDS_QUERY_ARGS_LEN - 1 - i] = (delayLedgerTime >> (8 * i)) & 0xFF;
+
+    // Call the provable_query and get the queryId
+    const eosio::checksum256 queryId = __provable_query(user, "random", std::vector<uint8_t>(args, args + sizeof(args)), proofType_Ledger, sender); // proofType and datasource are always fixed in this function
+
+    // Calculate the commitment and call a function to set it
+    std::array<uint8_t, 32> commitment_ba;
+    __provable_randomDS_commitment<__provable_randomDS_eosio_crypto>(args, commitment_ba.data());
+    const eosio::checksum256 commitment = eosio::checksum256(commitment_ba); // Container for the commitment hash
+    const name payer = user; // Payer for setting the commitment
+    __provable_randomDS_setCommitment(queryId, commitment, payer); // Call the function to set query Id and commitment in the table
+
+    return queryId;
 }
 
-uint8_t provable_randomDS_proofVerify(const eosio::checksum256 queryId, const std::vector<uint8_t> result, const std::vector<uint8_t> proof, const name payer)
+uint8_t __provable_randomDS_proofVerify(const eosio::checksum256 queryId, const std::vector<uint8_t> &result, const std::vector<uint8_t> &proof, const name payer)
 {
-    /*******************************************************************************************
-     *                                                                                         *
-     *   Step 1: the prefix has to match 'LP\x01' (Ledger Proof version 1)                     *
-     *                                                                                         *
-     *******************************************************************************************/
-    if (proof[0] != 'L' || proof[1] != 'P' || proof[2] != 1)
-        return 1;
-
-
-    /********************************************************************************************
-     *                                                                                          *
-     *   Step 2: the unique keyhash has to match with the sha256 of (context name +  queryId)    *
-     *                                                                                          *
-     ********************************************************************************************/
-    const uint8_t ledgerProofLength = 3 + 65 + (proof[3 + 65 + 1] + 2) + 32;
-    uint8_t keyhash[32];
-    std::memcpy(keyhash, &proof.data()[ledgerProofLength], 32);
-    eosio::checksum256 keyhash_sha = sha256((char *)keyhash, 32);
-    std::string keyhash_sha_str = checksum256_to_string(keyhash_sha);
-    uint8_t *first_word = (uint8_t *) &keyhash_sha.get_array()[0];
-    uint8_t *second_word = (uint8_t *) &keyhash_sha.get_array()[1];
-    std::string context_name_str = PROVABLE_NETWORK_NAME;
-    char context_name[context_name_str.size()];
-    context_name_str.copy(context_name, context_name_str.size());
-    uint8_t tbh2[sizeof(context_name) + 32];
-    std::memcpy(tbh2, &context_name, sizeof(context_name));
-    std::memcpy(tbh2 + sizeof(context_name), &queryId.get_array()[0], 16);
-    std::memcpy(tbh2 + sizeof(context_name) + 16, &queryId.get_array()[1], 16);
-    eosio::checksum256 calc_hash = invert_checksum256(sha256((char *)tbh2, sizeof(context_name) +
-16 + 16));
-    uint8_t tbh3[32];
-    std::memcpy(tbh3, &calc_hash.get_array()[0], 16);
-    std::memcpy(tbh3 + 16, &calc_hash.get_array()[1], 16);
-    eosio::checksum256 calc_hash_2 = sha256((char *)tbh3, 16 + 16);
-    uint8_t *first_word3 = (uint8_t *) &calc_hash_2.get_array()[0];
-    uint8_t *second_word3 = (uint8_t *) &calc_hash_2.get_array()[1];
-    if(checksum256_to_string(keyhash_sha) != checksum256_to_string(calc_hash_2))
-        return 2;
-
-
-    /********************************************************************************************
-     *                                                                                          *
-     *   Step 3: we assume sig1 is valid (it will be verified during step 5)                    *
-     *           and we verify if 'result' is the prefix of sha256(sig1)                        *
-     *                                                                                          *
-     ********************************************************************************************/
-    const uint8_t sig1_len = proof[ledgerProofLength + (32 + 8 + 1 + 32) + 1] + 2;
-    uint8_t sig1[sig1_len];
-    std::memcpy(sig1, &proof.data()[ledgerProofLength + (32 + 8 + 1 + 32)], sig1_len);
-    eosio::checksum256 sig1_hash = sha256((char *)sig1, sizeof(sig1));
-    if (!__provable_randomDS_matchBytes32Prefix(sig1_hash, result.data(), result.size(), proof[ledgerProofLength + 32 + 8]))
-        return 3;
-
-
-    /********************************************************************************************
-     *                                                                                          *
-     *   Step 4: commitment match verification,                                                 *
-     *           sha256(delay, nbytes, unonce, sessionKeyHash) == commitment in table.          *
-     *                                                                                          *
-     ********************************************************************************************/
-    const uint8_t slice_offset = 8 + 1 + 32; // delay + nbytes + unonceHashBa
-    uint8_t commitmentSlice1[slice_offset];
-    std::memcpy(commitmentSlice1, &proof.data()[ledgerProofLength + 32], sizeof(commitmentSlice1));
-    // Extract the session public key and calculate the session publick key hash
-    uint8_t sessionPubKey[64];
-    const uint16_t sig2offset = ledgerProofLength + 32 + (8 + 1 + 32) + sig1_len + 65; // ledgerProofLength+32+(8+1+32)+sig1.len+65
-    std::memcpy(sessionPubKey, &proof.data()[sig2offset - 64], sizeof(sessionPubKey));
-    eosio::checksum256 sessionPubkeyHash = invert_checksum256(sha256((char *)sessionPubKey,
-sizeof(sessionPubKey))); // Calculate the key hash
-    vector<uint8_t> sessionPubkeyHashBa(32); // Convert to bytearray the public key hash
-    sessionPubkeyHashBa = checksum256_to_vector32(sessionPubkeyHash);
-    // Recreate the lastCommitment to compare with the table one
-    uint8_t tbh[slice_offset + 32];
-    std::memcpy(tbh, &commitmentSlice1, slice_offset);
-    std::memcpy(tbh + slice_offset, &sessionPubkeyHashBa[0], 32);
-    eosio::checksum256 lastCommitment = sha256((char *)tbh, sizeof(tbh));
-    // Retrieve the table commitment
+    // Retrieve the table commitment, the proof fails at step 4 if it is missing or for another queryId
     ds_scommitment last_commitments(payer, payer.value);
     name myQueryId_short;
     std::memcpy(&myQueryId_short, &queryId.get_array()[0], sizeof(myQueryId_short));
-    // Check if the key value exists
     auto itr = last_commitments.find(myQueryId_short.value);
-    if (itr == last_commitments.end())
-        return 4;
-    // Check the query id with the one in the table
-    const std::string queryId_str__expected = checksum256_to_string(itr->queryid);
-    const std::string queryId_str = checksum256_to_string(queryId);
-    if (queryId_str != queryId_str__expected)
-        return 4;
-    // Check the commitment with the one in the table
-    const std::string lastCommitment_str__expected = checksum256_to_string(itr->commitment);
-    const std::string lastCommitment_str = checksum256_to_string(lastCommitment);
-    if (lastCommitment_str != lastCommitment_str__expected)
-        return 4;
-
-
-    /********************************************************************************************
-     *                                                                                          *
-     *   Step 5: validity verification for sig1 (keyhash and args signed with the sessionKey)   *
-     *                                                                                          *
-     ********************************************************************************************/
-    uint8_t toSign1[32 + 8 + 1 + 32];
-    std::memcpy(toSign1, &proof.data()[ledgerProofLength], sizeof(toSign1));
-    eosio::checksum256 toSign1_hash = sha256((char *)toSign1, sizeof(toSign1));
-    if (!__provable_randomDS_verifySig(toSign1_hash, sig1, sizeof(sig1), sessionPubKey))
-        return 5;
-
-
-    /********************************************************************************************
-     *                                                                                          *
-     *   Step 6:  verify the attestation signature,                                             *
-     *            APPKEY1 must sign the sessionKey from the correct ledger app (CODEHASH)       *
-     *                                                                                          *
-     ********************************************************************************************/
-    uint8_t sig2[proof[sig2offset + 1] + 2];
-    std::memcpy(sig2, &proof.data()[sig2offset], sizeof(sig2));
-    uint8_t appkey_pubkey[64];
-    std::memcpy(appkey_pubkey, &proof.data()[3 + 1], sizeof(appkey_pubkey));
-    uint8_t toSign2[1 + 65 + 32];
-    toSign2[0] = 1; // role
-    std::memcpy(toSign2 + 1, &proof.data()[sig2offset - 65], 65);
-    std::memcpy(toSign2 + 65 + 1, CODE_HASH_RANDOMDS, 32);
-    eosio::checksum256 toSign2_hash = sha256((char *)toSign2, sizeof(toSign2));
-    if (!__provable_randomDS_verifySig(toSign2_hash, sig2, sizeof(sig2), appkey_pubkey))
-        return 6;
-
-
-    /********************************************************************************************
-     *                                                                                          *
-     *   Step 7: verify the APPKEY1 provenance (must be signed by Ledger)                       *
-     *                                                                                          *
-     ********************************************************************************************/
-    uint8_t toSign3[1 + 65];
-    toSign3[0] = 0xfe;
-    std::memcpy(toSign3 + 1, &proof.data()[3], 65);
-    uint8_t sig3[proof[3 + 65 + 1] + 2];
-    std::memcpy(sig3, &proof.data()[3 + 65], sizeof(sig3));
-    eosio::checksum256 toSign3_hash = sha256((char *)toSign3, sizeof(toSign3));
-    if (!__provable_randomDS_verifySig(toSign3_hash, sig3, sizeof(sig3), LEDGERKEY))
-        return 7;
-
-
+    std::array<uint8_t, 32> commitment;
+    const bool commitment_found = itr != last_commitments.end() && itr->queryid == queryId;
+    if (commitment_found)
+        commitment = itr->commitment.extract_as_byte_array();
+    uint8_t queryId_ba[32];
+    std::memcpy(queryId_ba, queryId.get_array().data(), 32);
+    const uint8_t proof_code = provable_proofVerifier<__provable_randomDS_eosio_crypto, provable_network_default, proofType_Ledger>::verify(queryId_ba,
+        result.data(), result.size(), proof.data(), proof.size(), commitment_found ? commitment.data() : nullptr);
+    if (proof_code != 0)
+        return proof_code;
     // Erase the commitment after the proof is verified
-    auto itr2 = last_commitments.find(myQueryId_short.value);
-    last_commitments.erase(itr2);
+    last_commitments.erase(itr);
     return 0;
 }
 
+uint8_t provable_randomDS_proofVerify(const eosio::checksum256 queryId, const std::vector<uint8_t> result, const std::vector<uint8_t> proof, const name payer)
+{
+    const uint8_t proof_code = __provable_randomDS_proofVerify(queryId, result, proof, payer);
+    __provable_telemetry_callback(queryId, proof_code, result.size(), proof.size(), payer);
+    return proof_code;
+}
+
 #endif
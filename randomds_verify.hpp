@@ -0,0 +1,300 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+#ifndef PROVABLERANDOMDS_H
+    #define PROVABLERANDOMDS_H
+
+
+/**************************************************
+ *                    INCLUDE                     *
+ *                   Libraries                    *
+ **************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <array>
+#include <cstring>
+
+
+/**************************************************
+ *                    CONSTANTS                   *
+ *                   Proof Types                  *
+ **************************************************/
+const uint8_t proofType_NONE = 0x00;
+const uint8_t proofType_TLSNotary = 0x10;
+const uint8_t proofType_Ledger = 0x30;
+const uint8_t proofType_Android = 0x40;
+const uint8_t proofType_Native = 0xF0;
+const uint8_t proofStorage_IPFS = 0x01;
+
+
+/**************************************************
+ *                    CONSTANTS                   *
+ *                    Networks                    *
+ **************************************************/
+// The context name is hashed together with the queryId in the proof keyhash
+struct provable_network_mainnet
+{
+    static constexpr char context_name[] = "eosio_mainnet";
+};
+
+struct provable_network_jungle
+{
+    static constexpr char context_name[] = "eosio_testnet_jungle";
+};
+
+struct provable_network_kylin
+{
+    static constexpr char context_name[] = "eosio_testnet_kylin";
+};
+
+struct provable_network_unknown
+{
+    static constexpr char context_name[] = "eosio_unknown";
+};
+
+
+/**************************************************
+ *                    CONSTANTS                   *
+ *                   Random DS                    *
+ **************************************************/
+// The Random DS code shared by the contracts (eos_api.hpp) and the native tools, it has no dependency on
+// the EOSIO CDT: hashing and signature checks go through a Crypto class, which has to provide
+//   static void sha256(const uint8_t *data, const size_t data_len, uint8_t digest[32]);
+//   static bool verify(const uint8_t digest[32], const uint8_t r[32], const uint8_t s[32], const uint8_t pubkey[64]);
+// verify() has to accept the signature if it is valid for either the pubkey or its opposite (the recovered
+// key is compared with the x coordinate only). Malformed proofs never abort: they fail the step reading them.
+constexpr uint8_t CODE_HASH_RANDOMDS[32] = {
+    253, 148, 250, 113, 188, 11, 161, 13, 57, 212, 100, 208, 216, 244, 101, 239, 238, 240, 162, 118, 78, 56, 135, 252, 201, 223, 65, 222, 210, 15, 80, 92
+};
+constexpr uint8_t LEDGERKEY[64] = {
+    127, 185, 86, 70, 156, 92, 155, 137, 132, 13, 85, 180, 53, 55, 230, 106, 152, 221, 72, 17, 234, 10, 39, 34, 66, 114, 194, 229, 98, 41, 17, 232, 83, 122, 47, 142, 134, 164, 107, 174, 200, 40, 100, 233, 141, 208, 30, 156, 204, 47, 139, 197, 223, 201, 203, 229, 169, 26, 41, 4, 152, 221, 150, 228
+};
+
+// Random query args: unonceHash (32) + nbytes (1) + sessionPubkeyHash (32) + delay big endian (32)
+const uint8_t RANDOMDS_QUERY_ARGS_LEN = 32 + 1 + 32 + 32;
+
+
+/**************************************************
+ *                   RANDOM DS                    *
+ *                 Implementation                 *
+ **************************************************/
+// Commitment of a random query, sha256(delay, nbytes, sha256(unonceHash), sessionPubkeyHash), from its args
+template <typename Crypto>
+void __provable_randomDS_commitment(const uint8_t args[RANDOMDS_QUERY_ARGS_LEN], uint8_t commitment[32])
+{
+    uint8_t commitmentTbh[8 + 1 + 32 + 32];
+    // Delay as 8 bytes little endian, from the last 4 bytes of the big endian one
+    std::memset(commitmentTbh, 0, 8);
+    for (int i = 0; i < 4; i++)
+        commitmentTbh[i] = args[RANDOMDS_QUERY_ARGS_LEN - 1 - i];
+    commitmentTbh[8] = args[32]; // nbytes
+    Crypto::sha256(args, 32, commitmentTbh + 8 + 1); // unonce has to be passed hashed
+    std::memcpy(commitmentTbh + 8 + 1 + 32, args + 32 + 1, 32); // sessionPubkeyHash
+    Crypto::sha256(commitmentTbh, sizeof(commitmentTbh), commitment);
+}
+
+// Return false if the component does not fit in the signature
+inline bool __provable_randomDS_get_signature_component(uint8_t component[32], const uint8_t signature[], const size_t signature_len, const size_t length_idx)
+{
+    if (signature_len <= length_idx)
+        return false;
+    const uint8_t component_len = signature[length_idx];
+    const uint8_t byte_to_jump = component_len % 32;
+    if (length_idx + 1 + component_len > signature_len || component_len - byte_to_jump > 32)
+        return false;
+    std::memcpy(component, &signature[length_idx + 1 + byte_to_jump], component_len - byte_to_jump);
+    return true;
+}
+
+inline bool __provable_randomDS_matchBytes32Prefix(const uint8_t digest[32], const uint8_t prefix[], const size_t prefix_len, const uint8_t n_random_bytes)
+{
+    // Prefix length and random bytes number should match, and be at most 32
+    if (prefix_len != n_random_bytes || n_random_bytes > 32)
+        return false;
+    return std::memcmp(digest, prefix, n_random_bytes) == 0;
+}
+
+template <typename Crypto>
+bool __provable_randomDS_verifySig(const uint8_t digest[32], const uint8_t der_signature[], const size_t der_signature_len, const uint8_t pubkey[64])
+{
+    uint8_t r[32] = {0};
+    uint8_t s[32] = {0};
+    if (der_signature_len < 4 || !__provable_randomDS_get_signature_component(r, der_signature, der_signature_len, 3) ||
+        !__provable_randomDS_get_signature_component(s, der_signature, der_signature_len, 4 + der_signature[3] + 1))
+        return false;
+    return Crypto::verify(digest, r, s, pubkey);
+}
+
+// sha256 preimages of the attestation (step 6) and provenance (step 7) signatures, without the signed key
+constexpr std::array<uint8_t, 1 + 65 + 32> __provable_randomDS_toSign2Layout()
+{
+    std::array<uint8_t, 1 + 65 + 32> layout = {};
+    layout[0] = 1; // role
+    for (int i = 0; i < 32; i++)
+        layout[1 + 65 + i] = CODE_HASH_RANDOMDS[i];
+    return layout;
+}
+
+constexpr std::array<uint8_t, 1 + 65> __provable_randomDS_toSign3Layout()
+{
+    std::array<uint8_t, 1 + 65> layout = {};
+    layout[0] = 0xfe;
+    return layout;
+}
+
+// Proof verifier for a network and a proof type, only the specialized proof types can be verified
+template <typename Crypto, typename Network, uint8_t ProofType>
+struct provable_proofVerifier;
+
+template <typename Crypto, typename Network>
+struct provable_proofVerifier<Crypto, Network, proofType_Ledger>
+{
+    // 'LP\x01' + APPKEY1 (65) + sig3 (DER) + 32 + keyhash (32) + delay (8) + nbytes (1) + sha256(unonceHash) (32) + sig1 (DER) + sessionPubKey (65) + sig2 (DER)
+    static constexpr size_t appkey1_offset = 3;
+    static constexpr size_t sig3_offset = appkey1_offset + 65;
+    static constexpr uint8_t slice_offset = 8 + 1 + 32; // delay + nbytes + unonceHashBa
+    static constexpr size_t toSign1_len = 32 + slice_offset;
+    static constexpr size_t context_name_len = sizeof(Network::context_name) - 1;
+    static constexpr std::array<uint8_t, 1 + 65 + 32> toSign2_layout = __provable_randomDS_toSign2Layout();
+    static constexpr std::array<uint8_t, 1 + 65> toSign3_layout = __provable_randomDS_toSign3Layout();
+
+    // Return 0 if the proof is valid, otherwise the number of the step that failed. queryId is the memory layout
+    // of the eosio::checksum256, commitment is the expected one (nullptr if there is none for this queryId)
+    static uint8_t verify(const uint8_t queryId[32], const uint8_t result[], const size_t result_len, const uint8_t proof[], const size_t proof_len, const uint8_t *commitment)
+    {
+        /*******************************************************************************************
+         *                                                                                         *
+         *   Step 1: the prefix has to match 'LP\x01' (Ledger Proof version 1)                     *
+         *                                                                                         *
+         *******************************************************************************************/
+        // The proof has to hold at least the header, APPKEY1 and the sig3 length
+        if (proof_len <= sig3_offset + 1)
+            return 1;
+        if (proof[0] != 'L' || proof[1] != 'P' || proof[2] != 1)
+            return 1;
+
+
+        /********************************************************************************************
+         *                                                                                          *
+         *   Step 2: the unique keyhash has to match with the sha256 of (context name +  queryId)    *
+         *                                                                                          *
+         ********************************************************************************************/
+        const size_t sig3_len = proof[sig3_offset + 1] + 2;
+        const size_t ledgerProofLength = sig3_offset + sig3_len + 32;
+        if (ledgerProofLength + 32 > proof_len)
+            return 2;
+        const uint8_t *keyhash = &proof[ledgerProofLength];
+        uint8_t tbh2[context_name_len + 32];
+        std::memcpy(tbh2, Network::context_name, context_name_len);
+        std::memcpy(tbh2 + context_name_len, queryId, 32);
+        uint8_t calc_hash[32];
+        Crypto::sha256(tbh2, sizeof(tbh2), calc_hash);
+        if (std::memcmp(keyhash, calc_hash, 32) != 0)
+            return 2;
+
+
+        /********************************************************************************************
+         *                                                                                          *
+         *   Step 3: we assume sig1 is valid (it will be verified during step 5)                    *
+         *           and we verify if 'result' is the prefix of sha256(sig1)                        *
+         *                                                                                          *
+         ********************************************************************************************/
+        if (ledgerProofLength + toSign1_len + 1 >= proof_len)
+            return 3;
+        const size_t sig1_len = proof[ledgerProofLength + toSign1_len + 1] + 2;
+        const uint8_t *sig1 = &proof[ledgerProofLength + toSign1_len];
+        const size_t sig2offset = ledgerProofLength + toSign1_len + sig1_len + 65;
+        if (sig2offset - 65 > proof_len)
+            return 3;
+        uint8_t sig1_hash[32];
+        Crypto::sha256(sig1, sig1_len, sig1_hash);
+        if (!__provable_randomDS_matchBytes32Prefix(sig1_hash, result, result_len, proof[ledgerProofLength + 32 + 8]))
+            return 3;
+
+
+        /********************************************************************************************
+         *                                                                                          *
+         *   Step 4: commitment match verification,                                                 *
+         *           sha256(delay, nbytes, unonce, sessionKeyHash) == commitment in table.          *
+         *                                                                                          *
+         ********************************************************************************************/
+        // Extract the session public key and calculate the session public key hash
+        if (sig2offset > proof_len)
+            return 4;
+        const uint8_t *sessionPubKey = &proof[sig2offset - 64];
+        // Recreate the lastCommitment to compare with the table one
+        uint8_t tbh[slice_offset + 32];
+        std::memcpy(tbh, &proof[ledgerProofLength + 32], slice_offset);
+        Crypto::sha256(sessionPubKey, 64, tbh + slice_offset);
+        uint8_t lastCommitment[32];
+        Crypto::sha256(tbh, sizeof(tbh), lastCommitment);
+        if (commitment == nullptr || std::memcmp(lastCommitment, commitment, 32) != 0)
+            return 4;
+
+
+        /********************************************************************************************
+         *                                                                                          *
+         *   Step 5: validity verification for sig1 (keyhash and args signed with the sessionKey)   *
+         *                                                                                          *
+         ********************************************************************************************/
+        uint8_t toSign1_hash[32];
+        Crypto::sha256(&proof[ledgerProofLength], toSign1_len, toSign1_hash);
+        if (!__provable_randomDS_verifySig<Crypto>(toSign1_hash, sig1, sig1_len, sessionPubKey))
+            return 5;
+
+
+        /********************************************************************************************
+         *                                                                                          *
+         *   Step 6:  verify the attestation signature,                                             *
+         *            APPKEY1 must sign the sessionKey from the correct ledger app (CODEHASH)       *
+         *                                                                                          *
+         ********************************************************************************************/
+        if (sig2offset + 1 >= proof_len)
+            return 6;
+        const size_t sig2_len = proof[sig2offset + 1] + 2;
+        if (sig2offset + sig2_len > proof_len)
+            return 6;
+        std::array<uint8_t, 1 + 65 + 32> toSign2 = toSign2_layout;
+        std::memcpy(toSign2.data() + 1, &proof[sig2offset - 65], 65);
+        uint8_t toSign2_hash[32];
+        Crypto::sha256(toSign2.data(), toSign2.size(), toSign2_hash);
+        if (!__provable_randomDS_verifySig<Crypto>(toSign2_hash, &proof[sig2offset], sig2_len, &proof[appkey1_offset + 1]))
+            return 6;
+
+
+        /********************************************************************************************
+         *                                                                                          *
+         *   Step 7: verify the APPKEY1 provenance (must be signed by Ledger)                       *
+         *                                                                                          *
+         ********************************************************************************************/
+        std::array<uint8_t, 1 + 65> toSign3 = toSign3_layout;
+        std::memcpy(toSign3.data() + 1, &proof[appkey1_offset], 65);
+        uint8_t toSign3_hash[32];
+        Crypto::sha256(toSign3.data(), toSign3.size(), toSign3_hash);
+        if (!__provable_randomDS_verifySig<Crypto>(toSign3_hash, &proof[sig3_offset], sig3_len, LEDGERKEY))
+            return 7;
+
+        return 0;
+    }
+};
+
+#endif
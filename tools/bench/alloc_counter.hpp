@@ -0,0 +1,55 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+// Heap allocations counter of the benchmarks, replacing the global operator new: include it in one source file
+// of the program only. The allocations of the CDT stubs are not counted
+
+#ifndef PROVABLEALLOCCOUNTER_H
+    #define PROVABLEALLOCCOUNTER_H
+
+#include <stdlib.h>
+#include <new>
+#include "eosio/stub.hpp"
+
+inline thread_local size_t allocations = 0;
+
+void *operator new(const size_t size)
+{
+    if (eosio_stub::internal_depth == 0)
+        allocations++;
+    void *p = malloc(size > 0 ? size : 1);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, const size_t) noexcept
+{
+    free(p);
+}
+
+#endif
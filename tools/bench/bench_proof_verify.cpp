@@ -0,0 +1,189 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+// Benchmark of the Random DS proof verifier specialized per network, provable_proofVerifier<Crypto, Network,
+// proofType_Ledger>, against the verifier taking the context name at run time, with the eosio crypto of the
+// contracts (on the CDT stubs of cdt_stub) and the OpenSSL one of the bulk verifier. Both run on the same
+// synthetic proofs, valid up to step 6 (so every step is run) and rejected at step 2 (other queryId).
+//
+// Usage: provable_bench_proof_verify [rounds]
+
+#define PROVABLE_NETWORK_NAME "eosio_mainnet"
+#define CONTRACT_NAME "bench"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "alloc_counter.hpp"
+#include "eos_api.hpp"
+#include "legacy_proof_verify.hpp"
+#include "bulk_verifier/proof_fixture.hpp"
+#include "bulk_verifier/record_verifier.hpp"
+
+
+/**************************************************
+ *                   BENCHMARK                    *
+ *                 Implementation                 *
+ **************************************************/
+const size_t BENCH_PROOFS = 16;
+
+// The legacy verifier aborts on malformed proofs, the benchmark proofs are all well formed
+struct eosio_crypto_with_check : __provable_randomDS_eosio_crypto
+{
+    static void check(const bool condition, const char *msg)
+    {
+        eosio::check(condition, msg);
+    }
+};
+
+struct bench_proof
+{
+    std::vector<uint8_t> queryId; // memory layout of the eosio::checksum256
+    std::vector<uint8_t> result;
+    std::vector<uint8_t> proof;
+    uint8_t commitment[32];
+};
+
+typedef uint8_t (*proof_verifier)(const bench_proof &p);
+
+// As __provable_randomDS_proofVerify called it: the context name copied in a std::string at each call
+template <typename Crypto, typename Network>
+uint8_t runtime_verify(const bench_proof &p)
+{
+    const std::string context_name = Network::context_name;
+    return __legacy_randomDS_proofVerify<Crypto>(context_name.data(), context_name.size(), p.queryId.data(),
+        p.result.data(), p.result.size(), p.proof.data(), p.proof.size(), p.commitment);
+}
+
+template <typename Crypto, typename Network>
+uint8_t specialized_verify(const bench_proof &p)
+{
+    return provable_proofVerifier<Crypto, Network, proofType_Ledger>::verify(p.queryId.data(),
+        p.result.data(), p.result.size(), p.proof.data(), p.proof.size(), p.commitment);
+}
+
+template <typename Network>
+std::vector<bench_proof> make_bench_proofs(std::mt19937 &rng, const bool other_queryId)
+{
+    std::vector<bench_proof> proofs;
+    for (size_t i = 0; i < BENCH_PROOFS; i++)
+    {
+        const proof_fixture f = make_proof_fixture<Network>(rng, 8, 600);
+        bench_proof p = {f.queryId_memory(), f.result, f.proof, {}};
+        __provable_randomDS_commitment<openssl_crypto>(f.args.data(), p.commitment);
+        if (other_queryId)
+            p.queryId[0] ^= 1;
+        proofs.push_back(p);
+    }
+    return proofs;
+}
+
+struct verifier_run
+{
+    bool codes_ok;
+    double allocations;
+    double ns;
+};
+
+verifier_run run_verifier(const proof_verifier verify, const std::vector<bench_proof> &proofs, const uint8_t expected, const size_t rounds)
+{
+    verifier_run run = {true, 0, 0};
+    const size_t before = allocations;
+    for (const bench_proof &p : proofs)
+        run.codes_ok = run.codes_ok && verify(p) == expected;
+    run.allocations = (double)(allocations - before) / proofs.size();
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; r++)
+        for (const bench_proof &p : proofs)
+            verify(p);
+    run.ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (rounds * proofs.size());
+    return run;
+}
+
+// Print one line per crypto and proof set for the network, false if a verifier returned an unexpected code
+template <typename Network>
+bool bench_network(std::mt19937 &rng, const size_t rounds)
+{
+    struct proof_set
+    {
+        const char *name;
+        std::vector<bench_proof> proofs;
+        uint8_t expected;
+        size_t rounds;
+    };
+    const proof_set sets[] = {
+        {"every step", make_bench_proofs<Network>(rng, false), 7, rounds},
+        {"step 2 reject", make_bench_proofs<Network>(rng, true), 2, rounds * 10000},
+    };
+    struct crypto_verifiers
+    {
+        const char *name;
+        proof_verifier runtime;
+        proof_verifier specialized;
+    };
+    const crypto_verifiers cryptos[] = {
+        {"eosio", runtime_verify<eosio_crypto_with_check, Network>, specialized_verify<__provable_randomDS_eosio_crypto, Network>},
+        {"openssl", runtime_verify<openssl_crypto, Network>, specialized_verify<openssl_crypto, Network>},
+    };
+    bool ok = true;
+    for (const crypto_verifiers &c : cryptos)
+        for (const proof_set &s : sets)
+        {
+            const verifier_run runtime = run_verifier(c.runtime, s.proofs, s.expected, s.rounds);
+            const verifier_run specialized = run_verifier(c.specialized, s.proofs, s.expected, s.rounds);
+            printf("%-21s %-8s %-14s %10.1f %6.1f %10.1f %6.1f %7.2fx\n", Network::context_name, c.name, s.name,
+                runtime.ns, runtime.allocations, specialized.ns, specialized.allocations, runtime.ns / specialized.ns);
+            if (!runtime.codes_ok || !specialized.codes_ok)
+            {
+                fprintf(stderr, "Unexpected return code for the %s %s proofs of %s\n", c.name, s.name, Network::context_name);
+                ok = false;
+            }
+        }
+    return ok;
+}
+
+
+/**************************************************
+ *                      MAIN                      *
+ *                 Implementation                 *
+ **************************************************/
+int main(int argc, char **argv)
+{
+    const size_t rounds = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10;
+    if (rounds == 0)
+    {
+        fprintf(stderr, "Usage: %s [rounds]\n", argv[0]);
+        return 2;
+    }
+    std::mt19937 rng(1);
+    printf("%zu proofs per set, ns and heap allocations per proof, run time context name vs provable_proofVerifier<Crypto, Network, proofType_Ledger>\n", BENCH_PROOFS);
+    printf("%-21s %-8s %-14s %10s %6s %10s %6s %8s\n", "network", "crypto", "proofs", "runtime", "alloc", "special.", "alloc", "speedup");
+    bool ok = bench_network<provable_network_mainnet>(rng, rounds);
+    ok = bench_network<provable_network_jungle>(rng, rounds) && ok;
+    ok = bench_network<provable_network_kylin>(rng, rounds) && ok;
+    ok = bench_network<provable_network_unknown>(rng, rounds) && ok;
+    printf("The eosio crypto recovers the signing key twice per signature (v = 27 and 28) on the stubs, through OpenSSL.\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+// Benchmark of __provable_newRandomDSQuery against the version building the query args in vectors, on the CDT
+// stubs of cdt_stub: heap allocations and time per call, after checking that both send the same query args and
+// store the same commitment.
+//
+// Usage: provable_bench_random_query [iterations]
+
+#define PROVABLE_NETWORK_NAME "eosio_mainnet"
+#define CONTRACT_NAME "bench"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+#include "alloc_counter.hpp"
+#include "eos_api.hpp"
+#include "legacy_random_query.hpp"
+
+
+/**************************************************
+ *                   BENCHMARK                    *
+ *                 Implementation                 *
+ **************************************************/
+typedef eosio::checksum256 (*random_query_builder)(const name user, const uint32_t _delay, const uint8_t _nbytes, const name sender);
+
+const name BENCH_USER = "benchuser"_n;
+
+struct builder_run
+{
+    eosio::checksum256 queryId;
+    eosio::checksum256 commitment;
+    std::vector<char> action_data;
+    size_t allocations;
+};
+
+// Build one query, then take its commitment out of the table
+builder_run run_builder(const random_query_builder build, const uint32_t delay, const uint8_t nbytes)
+{
+    builder_run run;
+    const size_t before = allocations;
+    run.queryId = build(BENCH_USER, delay, nbytes, BENCH_USER);
+    run.allocations = allocations - before;
+    run.action_data = eosio_stub::last_action.data;
+    ds_scommitment commitments(BENCH_USER, BENCH_USER.value);
+    const auto itr = commitments.begin();
+    eosio::check(itr != commitments.end(), "No commitment stored");
+    run.commitment = itr->commitment;
+    commitments.erase(itr);
+    return run;
+}
+
+double ns_per_call(const random_query_builder build, const size_t iterations)
+{
+    ds_scommitment commitments(BENCH_USER, BENCH_USER.value);
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        build(BENCH_USER, 60, 8, BENCH_USER);
+        commitments.erase(commitments.begin());
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+
+/**************************************************
+ *                      MAIN                      *
+ *                 Implementation                 *
+ **************************************************/
+int main(int argc, char **argv)
+{
+    const size_t iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+    if (iterations == 0)
+    {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 2;
+    }
+
+    // Session pubkey hash published by the connector
+    ds_spubkey spubkeys("provableconn"_n, "provableconn"_n.value);
+    spubkeys.emplace("provableconn"_n, [&](auto &o) {
+        o.key = "1"_n;
+        o.randomDS_lastSessionPubkeyHash = eosio::sha256("session pubkey", 14);
+    });
+
+    const uint32_t delays[] = {0, 60, 30 * 24 * 3600};
+    const uint8_t nbytes[] = {1, 8, 32};
+    size_t cases = 0;
+    for (const uint32_t delay : delays)
+        for (const uint8_t n : nbytes)
+        {
+            eosio_stub::transaction_size = 100 + cases;
+            const builder_run legacy = run_builder(__legacy_provable_newRandomDSQuery, delay, n);
+            const builder_run current = run_builder(__provable_newRandomDSQuery, delay, n);
+            if (legacy.queryId != current.queryId || legacy.commitment != current.commitment || legacy.action_data != current.action_data)
+            {
+                fprintf(stderr, "Different query or commitment for delay %u, nbytes %u\n", delay, n);
+                return 1;
+            }
+            cases++;
+        }
+    printf("Same query args and commitment as the vector version in %zu cases\n", cases);
+
+    const builder_run legacy = run_builder(__legacy_provable_newRandomDSQuery, 60, 8);
+    const builder_run current = run_builder(__provable_newRandomDSQuery, 60, 8);
+    printf("__provable_newRandomDSQuery(60, 8), %zu calls:\n", iterations);
+    printf("  query args in vectors:       %3zu allocations, %7.1f ns/call\n", legacy.allocations, ns_per_call(__legacy_provable_newRandomDSQuery, iterations));
+    printf("  query args in stack buffers: %3zu allocations, %7.1f ns/call\n", current.allocations, ns_per_call(__provable_newRandomDSQuery, iterations));
+    printf("eos_api.hpp still heap-copies the stack buffer through std::vector<uint8_t>(args, args + sizeof(args)) to pass it\n"
+        "to __provable_query, and std::make_tuple copies it again into the action data.\n"
+        "The times include SHA-256 (OpenSSL) and the in-memory tables of the stubs, the action data packing is not counted.\n");
+    return 0;
+}
@@ -0,0 +1,135 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+#ifndef PROVABLESTUB_ACTION_H
+    #define PROVABLESTUB_ACTION_H
+
+#include <stdint.h>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "fixed_bytes.hpp"
+#include "name.hpp"
+#include "stub.hpp"
+
+namespace eosio_stub
+{
+    // Action data serialization, for the types sent by eos_api.hpp
+    template <typename T>
+    void pack(std::vector<char> &out, const T &value)
+    {
+        static_assert(std::is_arithmetic<T>::value, "Unsupported type");
+        const char *bytes = (const char *)&value;
+        out.insert(out.end(), bytes, bytes + sizeof(value));
+    }
+
+    inline void pack_varuint32(std::vector<char> &out, uint32_t value)
+    {
+        do
+        {
+            uint8_t b = value & 0x7f;
+            value >>= 7;
+            out.push_back(b | (value > 0 ? 0x80 : 0));
+        } while (value > 0);
+    }
+
+    inline void pack(std::vector<char> &out, const eosio::name &value)
+    {
+        pack(out, value.value);
+    }
+
+    inline void pack(std::vector<char> &out, const eosio::checksum256 &value)
+    {
+        const std::array<uint8_t, 32> bytes = value.extract_as_byte_array();
+        out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    inline void pack(std::vector<char> &out, const std::string &value)
+    {
+        pack_varuint32(out, value.size());
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    inline void pack(std::vector<char> &out, const std::vector<uint8_t> &value)
+    {
+        pack_varuint32(out, value.size());
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    template <typename T>
+    void pack(std::vector<char> &out, const std::vector<T> &value)
+    {
+        pack_varuint32(out, value.size());
+        for (const T &v : value)
+            pack(out, v);
+    }
+
+    template <typename... Args>
+    void pack(std::vector<char> &out, const std::tuple<Args...> &value)
+    {
+        std::apply([&](const Args &...args) { (pack(out, args), ...); }, value);
+    }
+
+    // The last action sent by the contract
+    struct sent_action
+    {
+        eosio::name account;
+        eosio::name name;
+        std::vector<char> data;
+    };
+
+    inline sent_action last_action;
+}
+
+namespace eosio
+{
+    struct permission_level
+    {
+        name actor;
+        name permission;
+    };
+
+    // Inline action, the data is packed as by the CDT but that is not counted as work of the contract
+    struct action
+    {
+        name account;
+        name action_name;
+        std::vector<char> data;
+
+        template <typename T>
+        action(const permission_level &, const struct name a, const struct name n, T &&value) : account(a), action_name(n)
+        {
+            eosio_stub::internal_scope scope;
+            data.reserve(256);
+            eosio_stub::pack(data, value);
+        }
+
+        void send() const
+        {
+            eosio_stub::internal_scope scope;
+            eosio_stub::last_action = {account, action_name, data};
+        }
+    };
+}
+
+#endif
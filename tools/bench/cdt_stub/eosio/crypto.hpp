@@ -0,0 +1,96 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+#ifndef PROVABLESTUB_CRYPTO_H
+    #define PROVABLESTUB_CRYPTO_H
+
+#include <stdint.h>
+#include <array>
+#include <variant>
+#include <vector>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/obj_mac.h>
+#include <openssl/sha.h>
+#include "fixed_bytes.hpp"
+
+namespace eosio
+{
+    // eos_api.hpp passes v (27 or 28), r and s in auth_data, so it is sized for them
+    struct webauthn_signature
+    {
+        std::vector<uint8_t> auth_data = std::vector<uint8_t>(65);
+    };
+
+    // Compressed secp256k1 key, 0x02/0x03 + x
+    struct webauthn_public_key
+    {
+        std::vector<char> key;
+    };
+
+    typedef std::variant<webauthn_signature> signature;
+    typedef std::variant<webauthn_public_key> public_key;
+
+    // The low level API, the one shot SHA256() of OpenSSL 3 looks the digest up at each call
+    inline checksum256 sha256(const char *data, const uint32_t length)
+    {
+        std::array<uint8_t, 32> hash;
+        SHA256_CTX sha;
+        SHA256_Init(&sha);
+        SHA256_Update(&sha, data, length);
+        SHA256_Final(hash.data(), &sha);
+        return checksum256(hash);
+    }
+
+    // secp256k1 public key recovery, Q = r^-1 (sR - eG) with R the point of x r and the y parity of v - 27.
+    // An empty key is returned if there is none
+    inline public_key recover_key(const checksum256 &digest, const signature &sig)
+    {
+        thread_local EC_GROUP *group = EC_GROUP_new_by_curve_name(NID_secp256k1);
+        thread_local BN_CTX *ctx = BN_CTX_new();
+        const std::vector<uint8_t> &vrs = std::get<webauthn_signature>(sig).auth_data;
+        const std::array<uint8_t, 32> e_ba = digest.extract_as_byte_array();
+        webauthn_public_key recovered;
+        BN_CTX_start(ctx);
+        BIGNUM *order = BN_CTX_get(ctx), *r = BN_CTX_get(ctx), *s = BN_CTX_get(ctx), *e = BN_CTX_get(ctx), *r_inv = BN_CTX_get(ctx),
+            *u1 = BN_CTX_get(ctx), *u2 = BN_CTX_get(ctx);
+        EC_POINT *R = EC_POINT_new(group), *Q = EC_POINT_new(group);
+        uint8_t compressed[33];
+        if (order != nullptr && u2 != nullptr && R != nullptr && Q != nullptr && vrs.size() >= 65 && (vrs[0] == 27 || vrs[0] == 28) &&
+            EC_GROUP_get_order(group, order, ctx) == 1 &&
+            BN_bin2bn(vrs.data() + 1, 32, r) != nullptr && BN_bin2bn(vrs.data() + 33, 32, s) != nullptr &&
+            BN_bin2bn(e_ba.data(), 32, e) != nullptr && !BN_is_zero(r) && BN_cmp(r, order) < 0 &&
+            EC_POINT_set_compressed_coordinates(group, R, r, vrs[0] - 27, ctx) == 1 &&
+            BN_mod_inverse(r_inv, r, order, ctx) != nullptr &&
+            BN_mod_mul(u1, e, r_inv, order, ctx) == 1 && BN_mod_sub(u1, order, u1, order, ctx) == 1 &&
+            BN_mod_mul(u2, s, r_inv, order, ctx) == 1 &&
+            EC_POINT_mul(group, Q, u1, R, u2, ctx) == 1 && !EC_POINT_is_at_infinity(group, Q) &&
+            EC_POINT_point2oct(group, Q, POINT_CONVERSION_COMPRESSED, compressed, sizeof(compressed), ctx) == sizeof(compressed))
+            recovered.key.assign(compressed, compressed + sizeof(compressed));
+        EC_POINT_free(R);
+        EC_POINT_free(Q);
+        BN_CTX_end(ctx);
+        return recovered;
+    }
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+#ifndef PROVABLESTUB_FIXED_BYTES_H
+    #define PROVABLESTUB_FIXED_BYTES_H
+
+#include <stdint.h>
+#include <array>
+
+namespace eosio
+{
+    // Bytes packed big endian in 128 bits words, as in the CDT: in memory each word is reversed
+    template <size_t Size>
+    class fixed_bytes
+    {
+        static_assert(Size % 16 == 0, "Only whole 128 bits words are supported");
+        static constexpr size_t num_words = Size / 16;
+        std::array<__uint128_t, num_words> _data = {};
+
+    public:
+        fixed_bytes() = default;
+
+        fixed_bytes(const std::array<uint8_t, Size> &arr)
+        {
+            for (size_t w = 0; w < num_words; w++)
+                for (size_t i = 0; i < 16; i++)
+                    _data[w] = (_data[w] << 8) | arr[16 * w + i];
+        }
+
+        const std::array<__uint128_t, num_words> &get_array() const { return _data; }
+
+        std::array<uint8_t, Size> extract_as_byte_array() const
+        {
+            std::array<uint8_t, Size> arr;
+            for (size_t w = 0; w < num_words; w++)
+                for (size_t i = 0; i < 16; i++)
+                    arr[16 * w + i] = (uint8_t)(_data[w] >> (8 * (15 - i)));
+            return arr;
+        }
+
+        bool operator==(const fixed_bytes &other) const { return _data == other._data; }
+        bool operator!=(const fixed_bytes &other) const { return _data != other._data; }
+    };
+
+    typedef fixed_bytes<32> checksum256;
+}
+
+#endif
@@ -0,0 +1,115 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+#ifndef PROVABLESTUB_MULTI_INDEX_H
+    #define PROVABLESTUB_MULTI_INDEX_H
+
+#include <stdint.h>
+#include <map>
+#include <utility>
+#include "check.hpp"
+#include "name.hpp"
+#include "stub.hpp"
+
+namespace eosio
+{
+    // In memory table, the rows of each (code, scope) live as long as the program
+    template <name TableName, typename T>
+    class multi_index
+    {
+        typedef std::map<uint64_t, T> rows_t;
+
+        static std::map<std::pair<uint64_t, uint64_t>, rows_t> &tables()
+        {
+            static std::map<std::pair<uint64_t, uint64_t>, rows_t> t;
+            return t;
+        }
+
+        rows_t *rows;
+
+    public:
+        class const_iterator
+        {
+            friend class multi_index;
+            typename rows_t::iterator it;
+
+        public:
+            const_iterator(typename rows_t::iterator i) : it(i) {}
+            const T &operator*() const { return it->second; }
+            const T *operator->() const { return &it->second; }
+            const_iterator &operator++() { ++it; return *this; }
+            bool operator==(const const_iterator &other) const { return it == other.it; }
+            bool operator!=(const const_iterator &other) const { return it != other.it; }
+        };
+
+        multi_index(const name code, const uint64_t scope)
+        {
+            eosio_stub::internal_scope s;
+            rows = &tables()[std::make_pair(code.value, scope)];
+        }
+
+        const_iterator begin() const { return rows->begin(); }
+        const_iterator end() const { return rows->end(); }
+        const_iterator find(const uint64_t primary) const { return rows->find(primary); }
+
+        const T &get(const uint64_t primary, const char *error_msg = "unable to find key") const
+        {
+            const auto it = rows->find(primary);
+            check(it != rows->end(), error_msg);
+            return it->second;
+        }
+
+        template <typename Lambda>
+        const_iterator emplace(const name, Lambda &&constructor)
+        {
+            T obj;
+            constructor(obj);
+            eosio_stub::internal_scope s;
+            const auto inserted = rows->emplace(obj.primary_key(), std::move(obj));
+            check(inserted.second, "could not insert object, most likely a uniqueness constraint was violated");
+            return inserted.first;
+        }
+
+        template <typename Lambda>
+        void modify(const const_iterator itr, const name, Lambda &&updater)
+        {
+            const uint64_t primary = itr.it->first;
+            updater(itr.it->second);
+            check(itr.it->second.primary_key() == primary, "updater cannot change primary key when modifying an object");
+        }
+
+        template <typename Lambda>
+        void modify(const T &obj, const name payer, Lambda &&updater)
+        {
+            modify(find(obj.primary_key()), payer, updater);
+        }
+
+        const_iterator erase(const_iterator itr)
+        {
+            check(itr != end(), "cannot pass end iterator to erase");
+            eosio_stub::internal_scope s;
+            return rows->erase(itr.it);
+        }
+    };
+}
+
+#endif
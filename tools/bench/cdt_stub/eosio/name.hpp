@@ -0,0 +1,92 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+#ifndef PROVABLESTUB_NAME_H
+    #define PROVABLESTUB_NAME_H
+
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include "check.hpp"
+
+namespace eosio
+{
+    // Account and table names, encoded in 64 bits as in the CDT
+    struct name
+    {
+        uint64_t value = 0;
+
+        constexpr name() = default;
+        constexpr explicit name(const uint64_t v) : value(v) {}
+        constexpr explicit name(std::string_view str)
+        {
+            for (size_t i = 0; i < str.size() && i < 13; i++)
+            {
+                const uint64_t c = char_to_value(str[i]);
+                value |= i < 12 ? (c & 0x1f) << (64 - 5 * (i + 1)) : c & 0x0f;
+            }
+        }
+
+        static constexpr uint8_t char_to_value(const char c)
+        {
+            if (c == '.')
+                return 0;
+            if (c >= '1' && c <= '5')
+                return (c - '1') + 1;
+            if (c >= 'a' && c <= 'z')
+                return (c - 'a') + 6;
+            return 0;
+        }
+
+        std::string to_string() const
+        {
+            static const char *charmap = ".12345abcdefghijklmnopqrstuvwxyz";
+            std::string str(13, '.');
+            uint64_t tmp = value;
+            for (int i = 0; i <= 12; i++)
+            {
+                const char c = charmap[tmp & (i == 0 ? 0x0f : 0x1f)];
+                str[12 - i] = c;
+                tmp >>= (i == 0 ? 4 : 5);
+            }
+            str.erase(str.find_last_not_of('.') + 1);
+            return str;
+        }
+
+        constexpr explicit operator bool() const { return value != 0; }
+        constexpr bool operator==(const name &other) const { return value == other.value; }
+        constexpr bool operator!=(const name &other) const { return value != other.value; }
+        constexpr bool operator<(const name &other) const { return value < other.value; }
+    };
+
+    inline namespace literals
+    {
+        constexpr name operator""_n(const char *str, const size_t len)
+        {
+            return name(std::string_view(str, len));
+        }
+    }
+}
+
+using namespace eosio::literals;
+
+#endif
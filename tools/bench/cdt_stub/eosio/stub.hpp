@@ -0,0 +1,51 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+// Native stand-ins of the EOSIO CDT headers used by eos_api.hpp, only meant to run it in the benchmarks of
+// tools/bench. The chain state read by the library (transaction and tapos values) is set through eosio_stub
+
+#ifndef PROVABLESTUB_STUB_H
+    #define PROVABLESTUB_STUB_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace eosio_stub
+{
+    // Allocations done while the depth is not 0 belong to the stubs, not to the code under benchmark
+    inline thread_local int internal_depth = 0;
+
+    struct internal_scope
+    {
+        internal_scope() { internal_depth++; }
+        ~internal_scope() { internal_depth--; }
+        internal_scope(const internal_scope &) = delete;
+        internal_scope &operator=(const internal_scope &) = delete;
+    };
+
+    inline size_t transaction_size = 128;
+    inline int tapos_block_num = 1000;
+    inline int tapos_block_prefix = 0x12345678;
+    inline uint32_t now = 1577836800;
+}
+
+#endif
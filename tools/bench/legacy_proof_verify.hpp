@@ -0,0 +1,178 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+// The Random DS proof verifier as it was before being specialized per network and proof type: the context name
+// is passed at run time and hashed through a variable length array. Renamed to run it next to the current one,
+// the Crypto class also has to provide static void check(const bool condition, const char *msg)
+
+#ifndef PROVABLELEGACYPROOFVERIFY_H
+    #define PROVABLELEGACYPROOFVERIFY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cstring>
+#include "randomds_verify.hpp"
+
+template <typename Crypto>
+void __legacy_randomDS_get_signature_component(uint8_t component[32], const uint8_t signature[], const size_t signature_len, const size_t length_idx)
+{
+    Crypto::check(signature_len > length_idx, "Invalid index");
+    const uint8_t component_len = signature[length_idx];
+    const uint8_t byte_to_jump = component_len % 32;
+    Crypto::check(length_idx + 1 + component_len <= signature_len, "Invalid signature component length");
+    std::memcpy(component, &signature[length_idx + 1 + byte_to_jump], component_len - byte_to_jump);
+}
+
+template <typename Crypto>
+bool __legacy_randomDS_matchBytes32Prefix(const uint8_t digest[32], const uint8_t prefix[], const size_t prefix_len, const uint8_t n_random_bytes)
+{
+    Crypto::check(prefix_len == n_random_bytes, "Prefix length and random bytes number should match.");
+    Crypto::check(n_random_bytes <= 32, "Random bytes number should be at most 32.");
+    return std::memcmp(digest, prefix, n_random_bytes) == 0;
+}
+
+template <typename Crypto>
+bool __legacy_randomDS_verifySig(const uint8_t digest[32], const uint8_t der_signature[], const size_t der_signature_len, const uint8_t pubkey[64])
+{
+    uint8_t r[32] = {0};
+    uint8_t s[32] = {0};
+    __legacy_randomDS_get_signature_component<Crypto>(r, der_signature, der_signature_len, 3);
+    __legacy_randomDS_get_signature_component<Crypto>(s, der_signature, der_signature_len, 4 + der_signature[3] + 1);
+    return Crypto::verify(digest, r, s, pubkey);
+}
+
+// Return 0 if the proof is valid, otherwise the number of the step that failed. queryId is the memory layout
+// of the eosio::checksum256, commitment is the expected one (nullptr if there is none for this queryId)
+template <typename Crypto>
+uint8_t __legacy_randomDS_proofVerify(const char *context_name, const size_t context_name_len, const uint8_t queryId[32],
+    const uint8_t result[], const size_t result_len, const uint8_t proof[], const size_t proof_len, const uint8_t *commitment)
+{
+    /*******************************************************************************************
+     *                                                                                         *
+     *   Step 1: the prefix has to match 'LP\x01' (Ledger Proof version 1)                     *
+     *                                                                                         *
+     *******************************************************************************************/
+    Crypto::check(proof_len > 3 + 65 + 1, "Invalid proof length");
+    if (proof[0] != 'L' || proof[1] != 'P' || proof[2] != 1)
+        return 1;
+
+
+    /********************************************************************************************
+     *                                                                                          *
+     *   Step 2: the unique keyhash has to match with the sha256 of (context name +  queryId)    *
+     *                                                                                          *
+     ********************************************************************************************/
+    const size_t ledgerProofLength = 3 + 65 + (proof[3 + 65 + 1] + 2) + 32;
+    Crypto::check(ledgerProofLength + (32 + 8 + 1 + 32) + 1 < proof_len, "Invalid proof length");
+    const uint8_t *keyhash = &proof[ledgerProofLength];
+    uint8_t tbh2[context_name_len + 32];
+    std::memcpy(tbh2, context_name, context_name_len);
+    std::memcpy(tbh2 + context_name_len, queryId, 32);
+    uint8_t calc_hash[32];
+    Crypto::sha256(tbh2, sizeof(tbh2), calc_hash);
+    if (std::memcmp(keyhash, calc_hash, 32) != 0)
+        return 2;
+
+
+    /********************************************************************************************
+     *                                                                                          *
+     *   Step 3: we assume sig1 is valid (it will be verified during step 5)                    *
+     *           and we verify if 'result' is the prefix of sha256(sig1)                        *
+     *                                                                                          *
+     ********************************************************************************************/
+    const size_t sig1_len = proof[ledgerProofLength + (32 + 8 + 1 + 32) + 1] + 2;
+    const uint8_t *sig1 = &proof[ledgerProofLength + (32 + 8 + 1 + 32)];
+    const size_t sig2offset = ledgerProofLength + 32 + (8 + 1 + 32) + sig1_len + 65;
+    Crypto::check(sig2offset + 1 < proof_len, "Invalid proof length");
+    uint8_t sig1_hash[32];
+    Crypto::sha256(sig1, sig1_len, sig1_hash);
+    if (!__legacy_randomDS_matchBytes32Prefix<Crypto>(sig1_hash, result, result_len, proof[ledgerProofLength + 32 + 8]))
+        return 3;
+
+
+    /********************************************************************************************
+     *                                                                                          *
+     *   Step 4: commitment match verification,                                                 *
+     *           sha256(delay, nbytes, unonce, sessionKeyHash) == commitment in table.          *
+     *                                                                                          *
+     ********************************************************************************************/
+    const uint8_t slice_offset = 8 + 1 + 32; // delay + nbytes + unonceHashBa
+    // Extract the session public key and calculate the session public key hash
+    const uint8_t *sessionPubKey = &proof[sig2offset - 64];
+    // Recreate the lastCommitment to compare with the table one
+    uint8_t tbh[slice_offset + 32];
+    std::memcpy(tbh, &proof[ledgerProofLength + 32], slice_offset);
+    Crypto::sha256(sessionPubKey, 64, tbh + slice_offset);
+    uint8_t lastCommitment[32];
+    Crypto::sha256(tbh, sizeof(tbh), lastCommitment);
+    if (commitment == nullptr || std::memcmp(lastCommitment, commitment, 32) != 0)
+        return 4;
+
+
+    /********************************************************************************************
+     *                                                                                          *
+     *   Step 5: validity verification for sig1 (keyhash and args signed with the sessionKey)   *
+     *                                                                                          *
+     ********************************************************************************************/
+    uint8_t toSign1_hash[32];
+    Crypto::sha256(&proof[ledgerProofLength], 32 + 8 + 1 + 32, toSign1_hash);
+    if (!__legacy_randomDS_verifySig<Crypto>(toSign1_hash, sig1, sig1_len, sessionPubKey))
+        return 5;
+
+
+    /********************************************************************************************
+     *                                                                                          *
+     *   Step 6:  verify the attestation signature,                                             *
+     *            APPKEY1 must sign the sessionKey from the correct ledger app (CODEHASH)       *
+     *                                                                                          *
+     ********************************************************************************************/
+    const size_t sig2_len = proof[sig2offset + 1] + 2;
+    Crypto::check(sig2offset + sig2_len <= proof_len, "Invalid proof length");
+    const uint8_t *sig2 = &proof[sig2offset];
+    const uint8_t *appkey_pubkey = &proof[3 + 1];
+    uint8_t toSign2[1 + 65 + 32];
+    toSign2[0] = 1; // role
+    std::memcpy(toSign2 + 1, &proof[sig2offset - 65], 65);
+    std::memcpy(toSign2 + 65 + 1, CODE_HASH_RANDOMDS, 32);
+    uint8_t toSign2_hash[32];
+    Crypto::sha256(toSign2, sizeof(toSign2), toSign2_hash);
+    if (!__legacy_randomDS_verifySig<Crypto>(toSign2_hash, sig2, sig2_len, appkey_pubkey))
+        return 6;
+
+
+    /********************************************************************************************
+     *                                                                                          *
+     *   Step 7: verify the APPKEY1 provenance (must be signed by Ledger)                       *
+     *                                                                                          *
+     ********************************************************************************************/
+    uint8_t toSign3[1 + 65];
+    toSign3[0] = 0xfe;
+    std::memcpy(toSign3 + 1, &proof[3], 65);
+    uint8_t toSign3_hash[32];
+    Crypto::sha256(toSign3, sizeof(toSign3), toSign3_hash);
+    if (!__legacy_randomDS_verifySig<Crypto>(toSign3_hash, &proof[3 + 65], proof[3 + 65 + 1] + 2, LEDGERKEY))
+        return 7;
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,108 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+// __provable_newRandomDSQuery and the bytearray __provable_query it calls as they were before the query args
+// were built in stack buffers, renamed to run them next to the current ones. Include after eos_api.hpp
+
+#ifndef PROVABLELEGACYRANDOMQUERY_H
+    #define PROVABLELEGACYRANDOMQUERY_H
+
+eosio::checksum256 __legacy_provable_query(const name user, const unsigned int timestamp, const std::string datasource, const vector<uint8_t> query, const uint8_t prooftype, const name sender)
+{
+    const eosio::checksum256 queryId = __provable_getNextQueryId(sender);
+    printhex(query.data(), query.size());
+    auto n = name{user};
+    const std::string str = n.to_string();
+    action(permission_level{user, "active"_n},
+        "provableconn"_n,
+        "queryba"_n,
+        std::make_tuple(sender, (int8_t)1, (uint32_t)timestamp, queryId, datasource, query, prooftype)
+    ).send();
+    return queryId;
+}
+
+eosio::checksum256 __legacy_provable_query(const name user, const std::string datasource, const vector<uint8_t> query, const uint8_t prooftype, const name sender)
+{
+    return __legacy_provable_query(user, 0, datasource, query, prooftype, sender);
+}
+
+eosio::checksum256 __legacy_provable_newRandomDSQuery(const name user, const uint32_t _delay, const uint8_t _nbytes, const name sender)
+{
+    // 1. NBYTES - Convert nbytes to bytearray
+    std::vector<uint8_t> nbytesBa(1);
+    nbytesBa[0] = _nbytes;
+
+    // 2. SESSIONKEYHASH - Get the sessionKeyHash from the ledger public key.
+    const eosio::checksum256 sessionPubkeyHash = __provable_randomDS_getSessionPubkeyHash();
+    std::vector<uint8_t> sessionPubkeyHashBa(32);
+    std::vector<uint8_t> sessionPubkeyHashBa2(32);
+    sessionPubkeyHashBa = checksum256_to_vector32(sessionPubkeyHash);
+
+    // 3. UNONCE - Need something block dependent so we decided to perform the hash of those 4 block dependent fields. This value have to be unpredictable from Provable
+    const size_t tx_size = transaction_size();
+    const int tapos_block_num_ = tapos_block_num();
+    const int tapos_block_prefix_ = tapos_block_prefix();
+    uint8_t unonce[sizeof(tx_size) + sizeof(tapos_block_num_) + sizeof(tapos_block_prefix_)]; // Fill the unonce array: now() + transaction_size + tapos_block_num + tapos_block_prefix
+    std::memcpy(unonce, &tx_size, sizeof(tx_size));
+    std::memcpy(unonce + sizeof(tx_size), &tapos_block_num_, sizeof(tapos_block_num_));
+    std::memcpy(unonce + sizeof(tx_size) + sizeof(tapos_block_num_), &tapos_block_prefix_, sizeof(tapos_block_prefix_));
+    eosio::checksum256 unonceHash = sha256((char *)unonce, sizeof(unonce)); // Container for the unonce hash
+    std::vector<uint8_t> unonceHashBa(32); // Convert the unonce hash in bytearray
+    unonceHashBa = checksum256_to_vector32(unonceHash);
+
+    // 4. DELAY - Delay converted in a big endian bytearray
+    const uint32_t delayLedgerTime = _delay * 10; // Convert from seconds to ledger timer ticks
+    std::vector<uint8_t> delayBaBigEndian(32);
+    delayBaBigEndian = uint32_to_vector32_bigendian(delayLedgerTime);
+
+    // Set args2 to be passed as params of the provable "random" query
+    std::vector<std::vector<uint8_t>> args;
+    args.push_back(unonceHashBa);
+    args.push_back(nbytesBa);
+    args.push_back(sessionPubkeyHashBa);
+    args.push_back(delayBaBigEndian);
+    std::vector<uint8_t> args2;
+    for(auto && a : args)
+        args2.insert(args2.end(), a.begin(), a.end());
+
+    // Call the provable_query and get the queryId
+    const eosio::checksum256 queryId = __legacy_provable_query(user,"random", args2, proofType_Ledger, sender); // proofType and datasource are always fixed in this function
+
+    // Calculate the commitment and call a function to set it
+    std::vector<uint8_t> delayBa(8); // delay converted to 8 byte
+    delayBa = uint32_to_vector8(delayLedgerTime);
+    uint8_t* charArray = &unonceHashBa[0];
+    eosio::checksum256 unonceHashBaHash = invert_checksum256(sha256((char *) charArray, unonceHashBa.size())); // unonce has to be passed hashed
+    uint8_t commitmentTbh[8 + 1 + 32 + args[2].size()]; // Calculate the commitment to be hashed with the size of: 8 + 1 + 32 + 32
+    std::memcpy(commitmentTbh, &delayBa[0], 8); // 8
+    std::memcpy(commitmentTbh + 8, &args[1][0], 1); // 8 + 1
+    std::memcpy(commitmentTbh + 8 + 1, &unonceHashBaHash.get_array()[0], 16); // 8 + 1 + 16
+    std::memcpy(commitmentTbh + 8 + 1 + 16, &unonceHashBaHash.get_array()[1], 16); // 8 + 1 + 32 == commitmentSlice1
+    std::memcpy(commitmentTbh + delayBa.size() + args[1].size() + 32, &args[2][0], args[2].size()); // 8 + 1 + 32 + 32 (commitmentSlice1 + sessionPubkeyHashBa)
+    eosio::checksum256 commitment = sha256((char *)commitmentTbh, sizeof(commitmentTbh)); // Container for the commitment hash
+    const name payer = user; // Payer for setting the commitment
+    __provable_randomDS_setCommitment(queryId, commitment, payer); // Call the function to set query Id and commitment in the table
+
+    return queryId;
+}
+
+#endif
@@ -0,0 +1,152 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+// Off-chain bulk verifier of Random DS Ledger proofs, sharing the verification code of the contracts.
+//
+// Usage: provable_bulk_verifier [-n network_name] [-t threads] <proofs file> <results file>
+//
+// The proofs file is a sequence of records, all the integers are little endian:
+//   [uint32 record_len][queryId (32)][query args (97)][uint32 result_len][result][uint32 proof_len][proof]
+// queryId is the checksum256 as serialized on chain (e.g. shown by cleos) and query args is the bytearray of
+// the "random" queryba action, the commitment is calculated from it as __provable_newRandomDSQuery does.
+// The results file gets one "<record index> <code>" line per record: the provable_randomDS_proofVerify return
+// code, or 255 for a malformed record.
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "record_verifier.hpp"
+#include "work_stealing_pool.hpp"
+
+
+/**************************************************
+ *                    CONSTANTS                   *
+ *                   Scheduling                   *
+ **************************************************/
+const size_t RECORD_GRAIN = 64;
+
+
+/**************************************************
+ *                      MAIN                      *
+ *                 Implementation                 *
+ **************************************************/
+void usage(const char *argv0)
+{
+    fprintf(stderr, "Usage: %s [-n network_name] [-t threads] <proofs file> <results file>\n", argv0);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    std::string context_name = "eosio_mainnet";
+    size_t n_threads = std::thread::hardware_concurrency();
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:")) != -1)
+    {
+        if (opt == 'n')
+            context_name = optarg;
+        else if (opt == 't')
+            n_threads = strtoul(optarg, nullptr, 10);
+        else
+            usage(argv[0]);
+    }
+    if (argc - optind != 2)
+        usage(argv[0]);
+    const record_verifier verify = select_verifier(context_name);
+    if (verify == nullptr)
+    {
+        fprintf(stderr, "Unknown network %s [possible values are \"eosio_mainnet\"/\"eosio_testnet_jungle\"/\"eosio_testnet_kylin\"/\"eosio_unknown\"]\n", context_name.c_str());
+        return 2;
+    }
+
+    const int fd = open(argv[optind], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        perror(argv[optind]);
+        return 1;
+    }
+    const size_t file_len = st.st_size;
+    const uint8_t *data = nullptr;
+    if (file_len > 0)
+    {
+        void *mapped = mmap(nullptr, file_len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED)
+        {
+            perror("mmap");
+            return 1;
+        }
+        madvise(mapped, file_len, MADV_WILLNEED);
+        data = (const uint8_t *)mapped;
+    }
+
+    // Index the records, only their length prefixes are read here
+    std::vector<std::pair<size_t, size_t>> records;
+    for (size_t offset = 0; offset < file_len;)
+    {
+        if (file_len - offset < 4 || read_uint32(data + offset) > file_len - offset - 4)
+        {
+            fprintf(stderr, "Truncated record at offset %zu\n", offset);
+            return 1;
+        }
+        const size_t record_len = read_uint32(data + offset);
+        records.emplace_back(offset + 4, record_len);
+        offset += 4 + record_len;
+    }
+
+    std::vector<uint8_t> codes(records.size());
+    const auto start = std::chrono::steady_clock::now();
+    work_stealing_pool pool(n_threads);
+    pool.parallel_for(records.size(), RECORD_GRAIN, [&](const size_t i) {
+        codes[i] = verify_record_code(verify, data + records[i].first, records[i].second);
+    });
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    FILE *out = fopen(argv[optind + 1], "w");
+    if (out == nullptr)
+    {
+        perror(argv[optind + 1]);
+        return 1;
+    }
+    size_t code_count[256] = {0};
+    for (size_t i = 0; i < codes.size(); i++)
+    {
+        fprintf(out, "%zu %u\n", i, codes[i]);
+        code_count[codes[i]]++;
+    }
+    fclose(out);
+
+    fprintf(stderr, "%zu %s proofs verified in %.3fs (%.0f proofs/s, %zu threads)\n", codes.size(), context_name.c_str(), elapsed,
+        elapsed > 0 ? codes.size() / elapsed : 0.0, std::max<size_t>(n_threads, 1));
+    for (size_t code = 0; code < 256; code++)
+        if (code_count[code] > 0)
+            fprintf(stderr, "  code %3zu: %zu\n", code, code_count[code]);
+    return 0;
+}
@@ -0,0 +1,213 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+// Synthetic Random DS Ledger proofs, laid out as the proofs verified by provable_randomDS_proofVerify. The keys
+// are random, so a proof built here is valid up to step 6: the APPKEY1 (sig3) cannot be signed by the Ledger key
+
+#ifndef PROVABLEPROOFFIXTURE_H
+    #define PROVABLEPROOFFIXTURE_H
+
+
+/**************************************************
+ *                    INCLUDE                     *
+ *                   Libraries                    *
+ **************************************************/
+#include <stdint.h>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/ecdsa.h>
+#include <openssl/obj_mac.h>
+#include <openssl/sha.h>
+#include "randomds_verify.hpp"
+
+
+/**************************************************
+ *                 PROOF FIXTURE                  *
+ *                 Implementation                 *
+ **************************************************/
+struct fixture_key
+{
+    EC_KEY *key;
+    uint8_t pubkey[65]; // 0x04 + x + y
+
+    fixture_key() : key(EC_KEY_new_by_curve_name(NID_secp256k1))
+    {
+        if (key == nullptr || EC_KEY_generate_key(key) != 1 ||
+            EC_POINT_point2oct(EC_KEY_get0_group(key), EC_KEY_get0_public_key(key), POINT_CONVERSION_UNCOMPRESSED, pubkey, sizeof(pubkey), nullptr) != sizeof(pubkey))
+            throw std::runtime_error("Cannot generate a secp256k1 key");
+    }
+    ~fixture_key() { EC_KEY_free(key); }
+    fixture_key(const fixture_key &) = delete;
+    fixture_key &operator=(const fixture_key &) = delete;
+
+    // DER signature of the sha256 of data. The contracts only read 32 or 33 bytes long r and s, so the
+    // signatures with shorter components are discarded
+    std::vector<uint8_t> sign(const std::vector<uint8_t> &data) const
+    {
+        uint8_t digest[32];
+        SHA256(data.data(), data.size(), digest);
+        for (;;)
+        {
+            ECDSA_SIG *sig = ECDSA_do_sign(digest, sizeof(digest), key);
+            if (sig == nullptr)
+                throw std::runtime_error("Cannot sign");
+            const BIGNUM *r, *s;
+            ECDSA_SIG_get0(sig, &r, &s);
+            if (BN_num_bits(r) > 248 && BN_num_bits(s) > 248)
+            {
+                std::vector<uint8_t> body;
+                der_integer(body, r);
+                der_integer(body, s);
+                ECDSA_SIG_free(sig);
+                std::vector<uint8_t> der = {0x30, (uint8_t)body.size()};
+                der.insert(der.end(), body.begin(), body.end());
+                return der;
+            }
+            ECDSA_SIG_free(sig);
+        }
+    }
+
+private:
+    static void der_integer(std::vector<uint8_t> &out, const BIGNUM *v)
+    {
+        uint8_t bytes[32];
+        BN_bn2binpad(v, bytes, sizeof(bytes));
+        const bool pad = bytes[0] & 0x80;
+        out.push_back(0x02);
+        out.push_back(pad ? 33 : 32);
+        if (pad)
+            out.push_back(0);
+        out.insert(out.end(), bytes, bytes + sizeof(bytes));
+    }
+};
+
+struct proof_fixture
+{
+    std::vector<uint8_t> queryId; // as serialized on chain
+    std::vector<uint8_t> args; // the "random" query args
+    std::vector<uint8_t> result;
+    std::vector<uint8_t> proof;
+    size_t ledgerProofLength;
+    size_t sig2offset;
+
+    // Record of the bulk verifier proofs files, with its length prefix
+    std::vector<uint8_t> record() const
+    {
+        const size_t record_len = queryId.size() + args.size() + 4 + result.size() + 4 + proof.size();
+        std::vector<uint8_t> rec;
+        rec.reserve(4 + record_len);
+        append_uint32(rec, record_len);
+        rec.insert(rec.end(), queryId.begin(), queryId.end());
+        rec.insert(rec.end(), args.begin(), args.end());
+        append_uint32(rec, result.size());
+        rec.insert(rec.end(), result.begin(), result.end());
+        append_uint32(rec, proof.size());
+        rec.insert(rec.end(), proof.begin(), proof.end());
+        return rec;
+    }
+
+    // queryId as laid out in memory by eosio::checksum256, each 16 bytes word reversed
+    std::vector<uint8_t> queryId_memory() const
+    {
+        std::vector<uint8_t> mem(32);
+        for (size_t i = 0; i < 16; i++)
+        {
+            mem[15 - i] = queryId[i];
+            mem[31 - i] = queryId[16 + i];
+        }
+        return mem;
+    }
+
+private:
+    static void append_uint32(std::vector<uint8_t> &out, const size_t v)
+    {
+        for (int i = 0; i < 4; i++)
+            out.push_back((uint8_t)(v >> (8 * i)));
+    }
+};
+
+// Build the query args and a proof valid up to step 6 for the given network
+template <typename Network>
+proof_fixture make_proof_fixture(std::mt19937 &rng, const uint8_t nbytes, const uint32_t delay)
+{
+    const fixture_key appkey1, session;
+    proof_fixture f;
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (int i = 0; i < 32; i++)
+        f.queryId.push_back(byte(rng));
+    uint8_t hash[32];
+
+    // unonceHash + nbytes + sha256(sessionPubKey without its 0x04 prefix) + delay (32 bytes big endian)
+    for (int i = 0; i < 32; i++)
+        f.args.push_back(byte(rng));
+    f.args.push_back(nbytes);
+    SHA256(session.pubkey + 1, 64, hash);
+    f.args.insert(f.args.end(), hash, hash + 32);
+    f.args.resize(RANDOMDS_QUERY_ARGS_LEN, 0);
+    for (int i = 0; i < 4; i++)
+        f.args[RANDOMDS_QUERY_ARGS_LEN - 1 - i] = (uint8_t)(delay >> (8 * i));
+
+    // keyhash = sha256(context name + queryId), then delay (8 bytes little endian) + nbytes + sha256(unonceHash)
+    const std::vector<uint8_t> queryId_mem = f.queryId_memory();
+    std::vector<uint8_t> toSign1(Network::context_name, Network::context_name + sizeof(Network::context_name) - 1);
+    toSign1.insert(toSign1.end(), queryId_mem.begin(), queryId_mem.end());
+    SHA256(toSign1.data(), toSign1.size(), hash);
+    toSign1.assign(hash, hash + 32);
+    for (int i = 0; i < 8; i++)
+        toSign1.push_back(i < 4 ? (uint8_t)(delay >> (8 * i)) : 0);
+    toSign1.push_back(nbytes);
+    SHA256(f.args.data(), 32, hash);
+    toSign1.insert(toSign1.end(), hash, hash + 32);
+    const std::vector<uint8_t> sig1 = session.sign(toSign1);
+
+    std::vector<uint8_t> toSign2 = {1};
+    toSign2.insert(toSign2.end(), session.pubkey, session.pubkey + 65);
+    toSign2.insert(toSign2.end(), CODE_HASH_RANDOMDS, CODE_HASH_RANDOMDS + 32);
+    const std::vector<uint8_t> sig2 = appkey1.sign(toSign2);
+
+    std::vector<uint8_t> toSign3 = {0xfe};
+    toSign3.insert(toSign3.end(), appkey1.pubkey, appkey1.pubkey + 65);
+    const std::vector<uint8_t> sig3 = fixture_key().sign(toSign3);
+
+    // 'LP\x01' + APPKEY1 + sig3 + 32 + toSign1 + sig1 + sessionPubKey + sig2
+    f.proof = {'L', 'P', 1};
+    f.proof.insert(f.proof.end(), appkey1.pubkey, appkey1.pubkey + 65);
+    f.proof.insert(f.proof.end(), sig3.begin(), sig3.end());
+    f.proof.resize(f.proof.size() + 32, 0);
+    f.ledgerProofLength = f.proof.size();
+    f.proof.insert(f.proof.end(), toSign1.begin(), toSign1.end());
+    f.proof.insert(f.proof.end(), sig1.begin(), sig1.end());
+    f.proof.insert(f.proof.end(), session.pubkey, session.pubkey + 65);
+    f.sig2offset = f.proof.size();
+    f.proof.insert(f.proof.end(), sig2.begin(), sig2.end());
+
+    SHA256(sig1.data(), sig1.size(), hash);
+    f.result.assign(hash, hash + nbytes);
+    return f;
+}
+
+#endif
@@ -0,0 +1,162 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+// Verification of the records of the bulk verifier proofs files, see bulk_verifier.cpp for their format
+
+#ifndef PROVABLERECORDVERIFIER_H
+    #define PROVABLERECORDVERIFIER_H
+
+
+/**************************************************
+ *                    INCLUDE                     *
+ *                   Libraries                    *
+ **************************************************/
+#include <stdint.h>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/ecdsa.h>
+#include <openssl/obj_mac.h>
+#include <openssl/sha.h>
+#include "randomds_verify.hpp"
+
+
+/**************************************************
+ *                    CONSTANTS                   *
+ *                  Result Codes                  *
+ **************************************************/
+const uint8_t RESULT_MALFORMED = 0xFF;
+const size_t QUERYID_LEN = 32;
+
+
+/**************************************************
+ *                     CRYPTO                     *
+ *                 Implementation                 *
+ **************************************************/
+struct malformed_proof : std::runtime_error
+{
+    explicit malformed_proof(const char *msg) : std::runtime_error(msg) {}
+};
+
+struct openssl_crypto
+{
+    static void sha256(const uint8_t *data, const size_t data_len, uint8_t digest[32])
+    {
+        SHA256(data, data_len, digest);
+    }
+
+    // Only the x coordinate of the pubkey is checked on chain, so both the points with that x are tried
+    static bool verify(const uint8_t digest[32], const uint8_t r[32], const uint8_t s[32], const uint8_t pubkey[64])
+    {
+        thread_local EC_KEY *key = EC_KEY_new_by_curve_name(NID_secp256k1);
+        thread_local EC_POINT *point = EC_POINT_new(EC_KEY_get0_group(key));
+        const EC_GROUP *group = EC_KEY_get0_group(key);
+        ECDSA_SIG *sig = ECDSA_SIG_new();
+        ECDSA_SIG_set0(sig, BN_bin2bn(r, 32, nullptr), BN_bin2bn(s, 32, nullptr));
+        bool valid = false;
+        uint8_t compressed[33];
+        std::memcpy(compressed + 1, pubkey, 32);
+        for (uint8_t prefix = 0x02; prefix <= 0x03 && !valid; prefix++)
+        {
+            compressed[0] = prefix;
+            if (EC_POINT_oct2point(group, point, compressed, sizeof(compressed), nullptr) != 1 || EC_KEY_set_public_key(key, point) != 1)
+                continue;
+            valid = ECDSA_do_verify(digest, 32, sig, key) == 1;
+        }
+        ECDSA_SIG_free(sig);
+        return valid;
+    }
+
+    static void check(const bool condition, const char *msg)
+    {
+        if (!condition)
+            throw malformed_proof(msg);
+    }
+};
+
+
+/**************************************************
+ *                    RECORDS                     *
+ *                 Implementation                 *
+ **************************************************/
+inline uint32_t read_uint32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+template <typename Network>
+uint8_t verify_record(const uint8_t *record, const size_t record_len)
+{
+    size_t offset = QUERYID_LEN + RANDOMDS_QUERY_ARGS_LEN;
+    openssl_crypto::check(offset + 4 <= record_len, "Record too short");
+    const size_t result_len = read_uint32(record + offset);
+    openssl_crypto::check(result_len <= record_len - offset - 4, "Invalid result length");
+    const uint8_t *result = record + offset + 4;
+    offset += 4 + result_len;
+    openssl_crypto::check(offset + 4 <= record_len, "Record too short");
+    const size_t proof_len = read_uint32(record + offset);
+    openssl_crypto::check(proof_len == record_len - offset - 4, "Invalid proof length");
+    const uint8_t *proof = record + offset + 4;
+    // The contracts hash the queryId as laid out in memory by eosio::checksum256, each 16 bytes word reversed
+    uint8_t queryId[QUERYID_LEN];
+    for (size_t i = 0; i < 16; i++)
+    {
+        queryId[15 - i] = record[i];
+        queryId[31 - i] = record[16 + i];
+    }
+    uint8_t commitment[32];
+    __provable_randomDS_commitment<openssl_crypto>(record + QUERYID_LEN, commitment);
+    return provable_proofVerifier<openssl_crypto, Network, proofType_Ledger>::verify(queryId, result, result_len, proof, proof_len, commitment);
+}
+
+typedef uint8_t (*record_verifier)(const uint8_t *record, const size_t record_len);
+
+// The verifier is specialized at compile time for each network, the name only selects one of them
+inline record_verifier select_verifier(const std::string &context_name)
+{
+    if (context_name == provable_network_mainnet::context_name)
+        return verify_record<provable_network_mainnet>;
+    if (context_name == provable_network_jungle::context_name)
+        return verify_record<provable_network_jungle>;
+    if (context_name == provable_network_kylin::context_name)
+        return verify_record<provable_network_kylin>;
+    if (context_name == provable_network_unknown::context_name)
+        return verify_record<provable_network_unknown>;
+    return nullptr;
+}
+
+// Verify a record (without its length prefix), RESULT_MALFORMED if it cannot be parsed
+inline uint8_t verify_record_code(const record_verifier verify, const uint8_t *record, const size_t record_len)
+{
+    try
+    {
+        return verify(record, record_len);
+    }
+    catch (const malformed_proof &)
+    {
+        return RESULT_MALFORMED;
+    }
+}
+
+#endif
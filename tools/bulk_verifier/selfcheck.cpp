@@ -0,0 +1,215 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+// Known answer check of the Random DS verification steps on synthetic proofs: a proof valid up to step 6 has to
+// return 7, and corrupting or truncating each of its fields the number of the step reading it.
+//
+// Usage: provable_bulk_verifier_selfcheck [<proofs file> <expected results file>]
+// The optional files get the eosio_mainnet cases, in the bulk verifier formats, to check the tool end to end.
+
+#include <stdio.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "proof_fixture.hpp"
+#include "record_verifier.hpp"
+
+
+/**************************************************
+ *                     CASES                      *
+ *                 Implementation                 *
+ **************************************************/
+struct selfcheck_case
+{
+    std::string name;
+    std::vector<uint8_t> record; // with its length prefix
+    uint8_t expected;
+};
+
+void add_case(std::vector<selfcheck_case> &cases, const std::string &name, const proof_fixture &f, const uint8_t expected)
+{
+    cases.push_back({name, f.record(), expected});
+}
+
+// The result is the prefix of sha256(sig1), so it has to follow the changes of sig1 to get past step 3
+void update_result(proof_fixture &f)
+{
+    uint8_t hash[32];
+    const size_t sig1_offset = f.ledgerProofLength + 32 + 8 + 1 + 32;
+    SHA256(&f.proof[sig1_offset], f.sig2offset - 65 - sig1_offset, hash);
+    f.result.assign(hash, hash + f.result.size());
+}
+
+std::vector<selfcheck_case> mainnet_cases(std::mt19937 &rng)
+{
+    std::vector<selfcheck_case> cases;
+    const proof_fixture valid = make_proof_fixture<provable_network_mainnet>(rng, 8, 600);
+    const size_t L = valid.ledgerProofLength;
+    proof_fixture f;
+
+    add_case(cases, "valid up to step 6", valid, 7);
+    add_case(cases, "valid up to step 6, 32 random bytes", make_proof_fixture<provable_network_mainnet>(rng, 32, 60), 7);
+
+    f = valid;
+    f.proof[1] = 'X';
+    add_case(cases, "step 1: wrong prefix", f, 1);
+    f = valid;
+    f.proof.clear();
+    add_case(cases, "step 1: empty proof", f, 1);
+    f = valid;
+    f.proof.resize(50);
+    add_case(cases, "step 1: truncated in APPKEY1", f, 1);
+
+    f = valid;
+    f.queryId[0] ^= 1;
+    add_case(cases, "step 2: other queryId", f, 2);
+    add_case(cases, "step 2: other network", make_proof_fixture<provable_network_kylin>(rng, 8, 600), 2);
+    f = valid;
+    f.proof.resize(L + 16);
+    add_case(cases, "step 2: truncated in keyhash", f, 2);
+
+    f = valid;
+    f.result[0] ^= 1;
+    add_case(cases, "step 3: other result", f, 3);
+    f = valid;
+    f.result.pop_back();
+    add_case(cases, "step 3: result shorter than nbytes", f, 3);
+    f = valid;
+    f.proof.resize(L + 73 + 10);
+    add_case(cases, "step 3: truncated in sig1", f, 3);
+
+    f = valid;
+    f.args[40] ^= 1;
+    add_case(cases, "step 4: other session pubkey hash", f, 4);
+    f = valid;
+    f.args[RANDOMDS_QUERY_ARGS_LEN - 1] ^= 1;
+    add_case(cases, "step 4: other delay", f, 4);
+    f = valid;
+    f.proof.resize(valid.sig2offset - 10);
+    add_case(cases, "step 4: truncated in session pubkey", f, 4);
+
+    f = valid;
+    f.proof[L + 73 + 10] ^= 1;
+    update_result(f);
+    add_case(cases, "step 5: corrupted sig1", f, 5);
+    f = valid;
+    f.proof[L + 73 + 3] = 0x7f;
+    update_result(f);
+    add_case(cases, "step 5: sig1 r length out of bounds", f, 5);
+
+    f = valid;
+    f.proof[valid.sig2offset + 10] ^= 1;
+    add_case(cases, "step 6: corrupted sig2", f, 6);
+    f = valid;
+    f.proof.resize(valid.sig2offset);
+    add_case(cases, "step 6: no sig2", f, 6);
+    f = valid;
+    f.proof.resize(valid.sig2offset + 20);
+    add_case(cases, "step 6: truncated in sig2", f, 6);
+
+    selfcheck_case c = {"malformed: proof length past the record", valid.record(), RESULT_MALFORMED};
+    c.record[c.record.size() - valid.proof.size() - 4]++;
+    cases.push_back(c);
+    c = {"malformed: record shorter than queryId and args", valid.record(), RESULT_MALFORMED};
+    c.record.resize(4 + 64);
+    c.record[0] = 64;
+    c.record[1] = 0;
+    cases.push_back(c);
+    return cases;
+}
+
+// The fixture of each network is valid for its verifier only
+size_t check_networks(std::mt19937 &rng)
+{
+    size_t failures = 0;
+    const char *names[] = {provable_network_mainnet::context_name, provable_network_jungle::context_name, provable_network_kylin::context_name, provable_network_unknown::context_name};
+    const std::vector<uint8_t> records[] = {
+        make_proof_fixture<provable_network_mainnet>(rng, 8, 600).record(),
+        make_proof_fixture<provable_network_jungle>(rng, 8, 600).record(),
+        make_proof_fixture<provable_network_kylin>(rng, 8, 600).record(),
+        make_proof_fixture<provable_network_unknown>(rng, 8, 600).record(),
+    };
+    for (size_t v = 0; v < 4; v++)
+        for (size_t r = 0; r < 4; r++)
+        {
+            const uint8_t expected = v == r ? 7 : 2;
+            const uint8_t code = verify_record_code(select_verifier(names[v]), records[r].data() + 4, records[r].size() - 4);
+            if (code != expected)
+            {
+                printf("FAIL %s proof verified as %s: %u, expected %u\n", names[r], names[v], code, expected);
+                failures++;
+            }
+        }
+    printf("%s network specializations\n", failures == 0 ? "ok  " : "FAIL");
+    return failures;
+}
+
+
+/**************************************************
+ *                      MAIN                      *
+ *                 Implementation                 *
+ **************************************************/
+int main(int argc, char **argv)
+{
+    if (argc != 1 && argc != 3)
+    {
+        fprintf(stderr, "Usage: %s [<proofs file> <expected results file>]\n", argv[0]);
+        return 2;
+    }
+    std::mt19937 rng(1);
+    const std::vector<selfcheck_case> cases = mainnet_cases(rng);
+    const record_verifier verify = select_verifier(provable_network_mainnet::context_name);
+    size_t failures = 0;
+    for (const selfcheck_case &c : cases)
+    {
+        const uint8_t code = verify_record_code(verify, c.record.data() + 4, c.record.size() - 4);
+        printf("%s %s: %u", code == c.expected ? "ok  " : "FAIL", c.name.c_str(), code);
+        if (code != c.expected)
+        {
+            printf(", expected %u", c.expected);
+            failures++;
+        }
+        printf("\n");
+    }
+    failures += check_networks(rng);
+
+    if (argc == 3)
+    {
+        FILE *proofs = fopen(argv[1], "wb");
+        FILE *expected = fopen(argv[2], "w");
+        if (proofs == nullptr || expected == nullptr)
+        {
+            perror("fopen");
+            return 1;
+        }
+        // Repeat the cases, so that the records are spread over the threads of the bulk verifier
+        for (size_t i = 0; i < 64 * cases.size(); i++)
+        {
+            const selfcheck_case &c = cases[i % cases.size()];
+            fwrite(c.record.data(), 1, c.record.size(), proofs);
+            fprintf(expected, "%zu %u\n", i, c.expected);
+        }
+        fclose(proofs);
+        fclose(expected);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+#ifndef PROVABLEWORKSTEALINGPOOL_H
+    #define PROVABLEWORKSTEALINGPOOL_H
+
+
+/**************************************************
+ *                    INCLUDE                     *
+ *                   Libraries                    *
+ **************************************************/
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+/**************************************************
+ *               WORK STEALING POOL               *
+ *                 Implementation                 *
+ **************************************************/
+// Run fn(i) for every i in [0, n_items) on n_threads threads. The items are split in chunks of grain items,
+// each thread starts with a contiguous share of the chunks and, once it runs out, steals from the others
+class work_stealing_pool
+{
+public:
+    explicit work_stealing_pool(const size_t n_threads) : queues(std::max<size_t>(n_threads, 1)) {}
+
+    template <typename F>
+    void parallel_for(const size_t n_items, const size_t grain, F fn)
+    {
+        const size_t n_threads = queues.size();
+        const size_t chunk = std::max<size_t>(grain, 1);
+        const size_t n_chunks = (n_items + chunk - 1) / chunk;
+        for (size_t t = 0; t < n_threads; t++)
+        {
+            queues[t].chunks.clear();
+            for (size_t c = n_chunks * t / n_threads; c < n_chunks * (t + 1) / n_threads; c++)
+                queues[t].chunks.emplace_back(c * chunk, std::min(n_items, (c + 1) * chunk));
+        }
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < n_threads; t++)
+            threads.emplace_back([&, t]() { run(t, fn); });
+        run(0, fn);
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+private:
+    typedef std::pair<size_t, size_t> range;
+
+    struct queue
+    {
+        std::mutex mutex;
+        std::deque<range> chunks;
+    };
+
+    std::vector<queue> queues;
+
+    // The owner takes from the back of its queue, thieves from the front
+    bool pop(const size_t t, range &r)
+    {
+        std::lock_guard<std::mutex> lock(queues[t].mutex);
+        if (queues[t].chunks.empty())
+            return false;
+        r = queues[t].chunks.back();
+        queues[t].chunks.pop_back();
+        return true;
+    }
+
+    bool steal(const size_t t, range &r)
+    {
+        for (size_t i = 1; i < queues.size(); i++)
+        {
+            queue &victim = queues[(t + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.chunks.empty())
+                continue;
+            r = victim.chunks.front();
+            victim.chunks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    template <typename F>
+    void run(const size_t t, F &fn)
+    {
+        range r;
+        // No work is ever added, so once there is nothing left to steal the thread is done
+        while (pop(t, r) || steal(t, r))
+            for (size_t i = r.first; i < r.second; i++)
+                fn(i);
+    }
+};
+
+#endif
@@ -0,0 +1,90 @@
+/*********************************************************************************
+ * Provable API                                                                  *
+ *                                                                               *
+ * Copyright (c) 2015-2016 Provable SRL                                          *
+ * Copyright (c) 2016 Provable LTD                                               *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy  *
+ * of this software and associated documentation files (the "Software"), to deal *
+ * in the Software without restriction, including without limitation the rights  *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell     *
+ * copies of the Software, and to permit persons to whom the Software is         *
+ * furnished to do so, subject to the following conditions:                      *
+ * The above copyright notice and this permission notice shall be included in    *
+ * all copies or substantial portions of the Software.                           *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR    *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,      *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE  *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER        *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN     *
+ * THE SOFTWARE.                                                                 *
+ *********************************************************************************/
+
+// Local stand-in of the provableconn connector for the query templates, to be deployed on a local or test
+// chain as the "provableconn" account. It handles the settemplate and querytpl actions sent by the contracts
+// and expands the templates with __provable_expandQueryTemplateBody, the same code used by
+// provable_expandQueryTemplate(...). The expanded query is printed instead of being sent to the oracle.
+//
+// Build: eosio-cpp -abigen -I ../.. provableconn.cpp -o provableconn.wasm
+
+#define CONTRACT_NAME "provableconn"
+#define PROVABLE_NETWORK_NAME "eosio_unknown"
+
+#include "eos_api.hpp"
+
+class [[eosio::contract("provableconn")]] provableconn : public eosio::contract
+{
+public:
+    using contract::contract;
+
+    [[eosio::action]]
+    void settemplate(const name sender, const name id, const std::string datasource, const std::vector<uint8_t> query, const uint8_t prooftype)
+    {
+        require_auth(sender);
+        ds_qtemplate templates(get_self(), sender.value);
+        auto itr = templates.find(id.value);
+        if (itr == templates.end())
+        {
+            templates.emplace(sender, [&](auto &o) {
+                o.id = id;
+                o.datasource = datasource;
+                o.query = query;
+                o.prooftype = prooftype;
+            });
+            return;
+        }
+        templates.modify(itr, sender, [&](auto &o) {
+            o.datasource = datasource;
+            o.query = query;
+            o.prooftype = prooftype;
+        });
+    }
+
+    [[eosio::action]]
+    void querytpl(const name sender, const int8_t version, const uint32_t timestamp, const eosio::checksum256 queryId, const name id, const std::vector<std::string> params)
+    {
+        require_auth(sender);
+        ds_qtemplate templates(get_self(), sender.value);
+        auto itr = templates.find(id.value);
+        eosio::internal_use_do_not_use::eosio_assert(itr != templates.end(), "Query template not found");
+        std::vector<uint8_t> query = __provable_expandQueryTemplateBody(itr->datasource, itr->query, params);
+        // The nonce is part of the next queryId, the connector increases it for every query
+        ds_snonce last_nonces(get_self(), get_self().value);
+        auto nonce_itr = last_nonces.find(sender.value);
+        if (nonce_itr == last_nonces.end())
+        {
+            last_nonces.emplace(get_self(), [&](auto &o) {
+                o.sender = sender;
+                o.nonce = 1;
+            });
+        }
+        else
+        {
+            last_nonces.modify(nonce_itr, get_self(), [&](auto &o) {
+                o.nonce++;
+            });
+        }
+        print("queryId: ", checksum256_to_string(queryId), ", datasource: ", itr->datasource, ", timestamp: ", timestamp,
+            ", prooftype: ", (uint32_t)itr->prooftype, ", query: ", vector_to_hexstring(&query));
+    }
+};